@@ -0,0 +1,339 @@
+import argparse
+import csv
+import logging
+import os
+import random
+import statistics
+import subprocess
+import time
+from concurrent.futures import ThreadPoolExecutor
+from typing import Dict, List, Tuple
+
+LOGGER = logging.getLogger(__name__)
+
+DEFAULT_MAPS = [
+    'empty-64-64.map',
+    'random-64-64-10.map',
+    'room-64-64-8.map',
+    'maze-128-128-10.map',
+    'warehouse-20-40-10-2-2.map',
+    'Paris_1_256.map',
+]
+DEFAULT_AGENTS = [50, 100, 200, 500, 1000, 2000]
+DEFAULT_SIZES = ['0.5-1', '1-2', '2-3', '3-4', '4-5', '5-6']
+
+RUN_FIELDS = [
+    'shape', 'map', 'sizes', 'agents', 'seed', 'status', 'solved',
+    'soc', 'lb_soc', 'makespan', 'lb_makespan',
+    'comp_time', 'preprocessing_comp_time', 'time_per_timestep', 'throughput',
+]
+SUMMARY_FIELDS = [
+    'shape', 'map', 'sizes', 'agents', 'runs', 'instance_errors',
+    'success_rate', 'mean_comp_time', 'mean_time_per_timestep', 'mean_throughput',
+    'mean_soc_over_lb',
+]
+
+
+def parse_arguments() -> argparse.Namespace:
+    """
+    Parse command line arguments.
+
+    Returns
+    -------
+    argparse.Namespace
+        The parsed command line arguments.
+    """
+    parser = argparse.ArgumentParser(
+        prog='scaling_benchmark',
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter
+    )
+
+    parser.add_argument('-b', '--build', type=str, action='append', default=[],
+                        help='Solver executable to benchmark, as shape=path/to/large-agents-mapf. Can be repeated.')
+    parser.add_argument('-m', '--maps', type=str, nargs='+', default=DEFAULT_MAPS, help='Map files to sweep over.')
+    parser.add_argument('-n', '--agents', type=int, nargs='+', default=DEFAULT_AGENTS, help='Agent counts to sweep over.')
+    parser.add_argument('-z', '--sizes', type=str, nargs='+', default=DEFAULT_SIZES,
+                        help='Size ranges to sweep over, as lower-upper bounds of uniformly drawn sizes.')
+    parser.add_argument('-r', '--seeds', type=int, default=5, help='Number of instances per sweep point.')
+    parser.add_argument('-T', '--time-limit', type=int, default=60000, help='max_comp_time of every instance (ms).')
+    parser.add_argument('-t', '--max-timestep', type=int, default=5000, help='max_timestep of every instance.')
+    parser.add_argument('-j', '--jobs', type=int, default=1,
+                        help='Solver processes running at once. Keep 1 for comparable timings.')
+    parser.add_argument('-o', '--output', type=str, default='benchmark-results', help='Output folder.')
+    parser.add_argument('-p', '--plot-only', action='store_true',
+                        help='Skip solving and only redraw curves from the summaries in the output folder.')
+    parser.add_argument('-v', '--verbose', action='store_true', help='Whether to print every run.')
+
+    return parser.parse_args()
+
+
+def check_arguments_validity(args: argparse.Namespace):
+    """
+    Check the validity of the command line arguments.
+
+    Raises
+    ------
+    AssertionError
+        If any of the arguments are invalid.
+    """
+    if args.plot_only:
+        return
+
+    assert args.build, 'At least one --build shape=executable has to be given'
+    for build in args.build:
+        assert '=' in build, f'Build has to be given as shape=executable. Found {build}'
+        shape, executable = build.split('=', 1)
+        assert shape in ['circle', 'square'], f'Shape can only be circle or square. Found {shape}'
+        assert os.access(executable, os.X_OK), f'Solver executable {executable} is not found'
+
+    for sizes in args.sizes:
+        lower, upper = parse_size_range(sizes)
+        assert 0 < lower <= upper, f'Size range has to be lower-upper with 0 < lower <= upper. Found {sizes}'
+
+    assert args.seeds > 0 and args.jobs > 0, 'The number of seeds and jobs has to be positive'
+
+
+def parse_size_range(sizes: str) -> Tuple[float, float]:
+    lower, upper = sizes.split('-')
+    return float(lower), float(upper)
+
+
+def size_range_folder(sizes: str) -> str:
+    """Name of the folder of a size range, following tests/problems, e.g. 0.1-3 -> 0_1-3."""
+    return sizes.replace('.', '_')
+
+
+def write_instance(path: str, map_file: str, agents: int, sizes: str, seed: int,
+                   max_timestep: int, max_comp_time: int, shape: str = 'square'):
+    """
+    Write an instance file in the format of tests/problems.
+    The sizes are drawn here from the seed and written as sizes=, since the solver draws
+    sizes_random_uniform= from std::random_device. So every build and every rerun gets the same
+    instance for the same sweep point.
+    """
+    lower, upper = parse_size_range(sizes)
+    generator = random.Random(seed)
+    agent_sizes = ', '.join(f'{generator.uniform(lower, upper):.6g}' for _ in range(agents))
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, 'w') as instance_file:
+        instance_file.write(
+            f'map_file={map_file}\n'
+            f'agents={agents}\n'
+            f'sizes={agent_sizes}\n'
+            f'shape={shape}\n'
+            f'seed={seed}\n'
+            f'random_problem=1\n'
+            f'well_formed=1\n'
+            f'max_timestep={max_timestep}\n'
+            f'max_comp_time={max_comp_time}\n'
+        )
+
+
+def read_result(path: str) -> Dict[str, str]:
+    result = {}
+    with open(path, 'r') as result_file:
+        for line in result_file.read().split('\n'):
+            if '=' in line:
+                key, value = line.split('=', 1)
+                result[key] = value
+    return result
+
+
+def run_instance(executable: str, instance: str, result: str, time_limit: int) -> Dict[str, object]:
+    """
+    Solve one instance with a short log and collect the basic info written by makeLog.
+
+    The status is one of:
+    - `solved`: the solver converged and the plan passed validation,
+    - `failed`: the solver did not converge, or produced an invalid plan,
+    - `instance_error`: no valid instance could be generated (e.g. agents do not fit on the map).
+    """
+    if os.path.exists(result):
+        os.remove(result)
+
+    try:
+        process = subprocess.run(
+            [executable, '-i', instance, '-s', 'LAPIBT', '-o', result, '-L'],
+            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True,
+            timeout=2 * time_limit / 1000 + 60,
+        )
+        stdout = process.stdout
+    except subprocess.TimeoutExpired:
+        return {'status': 'failed', 'solved': 0}
+
+    if 'error@Problem' in stdout or not os.path.exists(result):
+        return {'status': 'instance_error', 'solved': 0}
+
+    run = read_result(result)
+    solved = int(run.get('solved', 0)) == 1 and 'invalid results' not in stdout
+    makespan = int(run.get('makespan', 0))
+    comp_time = int(run.get('comp_time', 0))
+    planning_time = comp_time - int(run.get('preprocessing_comp_time', 0))
+    agents = int(run.get('agents', 0))
+
+    record = {
+        'status': 'solved' if solved else 'failed',
+        'solved': int(solved),
+        'soc': int(run.get('soc', 0)),
+        'lb_soc': int(run.get('lb_soc', 0)),
+        'makespan': makespan,
+        'lb_makespan': int(run.get('lb_makespan', 0)),
+        'comp_time': comp_time,
+        'preprocessing_comp_time': int(run.get('preprocessing_comp_time', 0)),
+    }
+    if makespan > 0:
+        # planning time per timestep (ms), and agent moves planned per second
+        record['time_per_timestep'] = planning_time / makespan
+        record['throughput'] = agents * makespan * 1000 / max(planning_time, 1)
+    return record
+
+
+def run_sweep(args: argparse.Namespace) -> List[Dict[str, object]]:
+    jobs = []
+    for build in args.build:
+        shape, executable = build.split('=', 1)
+        executable = os.path.abspath(executable)
+        for map_file in args.maps:
+            map_name = os.path.splitext(map_file)[0].replace('-', '_')
+            for sizes in args.sizes:
+                for agents in args.agents:
+                    for seed in range(args.seeds):
+                        problem = os.path.join(args.output, shape, 'problems', map_name,
+                                               size_range_folder(sizes), f'{agents}_{seed}.txt')
+                        result = os.path.join(args.output, shape, 'results', map_name,
+                                              size_range_folder(sizes), f'{agents}_{seed}.txt')
+                        write_instance(problem, map_file, agents, sizes, seed, args.max_timestep, args.time_limit,
+                                       shape)
+                        os.makedirs(os.path.dirname(result), exist_ok=True)
+                        jobs.append(({
+                            'shape': shape, 'map': map_file, 'sizes': sizes, 'agents': agents, 'seed': seed,
+                        }, executable, problem, result))
+
+    def work(job):
+        key, executable, problem, result = job
+        record = dict(key)
+        record.update(run_instance(executable, problem, result, args.time_limit))
+        LOGGER.debug(f"{key['shape']} {key['map']} sizes={key['sizes']} agents={key['agents']} "
+                     f"seed={key['seed']}: {record['status']}")
+        return record
+
+    LOGGER.info(f'Solving {len(jobs)} instances with {args.jobs} job(s)')
+    started = time.time()
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        runs = list(pool.map(work, jobs))
+    LOGGER.info(f'Done in {time.time() - started:.0f}s')
+    return runs
+
+
+def summarize(runs: List[Dict[str, object]]) -> List[Dict[str, object]]:
+    groups: Dict[tuple, List[Dict[str, object]]] = {}
+    for run in runs:
+        groups.setdefault((run['shape'], run['map'], run['sizes'], run['agents']), []).append(run)
+
+    summary = []
+    for (shape, map_file, sizes, agents), group in groups.items():
+        valid = [run for run in group if run['status'] != 'instance_error']
+        solved = [run for run in valid if run['solved']]
+
+        def mean(key, runs=solved):
+            values = [run[key] for run in runs if key in run]
+            return statistics.mean(values) if values else ''
+
+        summary.append({
+            'shape': shape, 'map': map_file, 'sizes': sizes, 'agents': agents,
+            'runs': len(valid),
+            'instance_errors': len(group) - len(valid),
+            'success_rate': len(solved) / len(valid) if valid else '',
+            'mean_comp_time': mean('comp_time', valid),
+            'mean_time_per_timestep': mean('time_per_timestep'),
+            'mean_throughput': mean('throughput'),
+            'mean_soc_over_lb': statistics.mean(
+                [run['soc'] / run['lb_soc'] for run in solved if run['lb_soc']]
+            ) if any(run['lb_soc'] for run in solved) else '',
+        })
+    return summary
+
+
+def write_csv(path: str, fields: List[str], rows: List[Dict[str, object]]):
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, 'w', newline='') as csv_file:
+        writer = csv.DictWriter(csv_file, fieldnames=fields, restval='')
+        writer.writeheader()
+        writer.writerows(rows)
+
+
+def read_summaries(output: str) -> List[Dict[str, str]]:
+    rows = []
+    for shape in sorted(os.listdir(output)):
+        path = os.path.join(output, shape, 'summary.csv')
+        if os.path.exists(path):
+            with open(path, 'r', newline='') as csv_file:
+                rows.extend(csv.DictReader(csv_file))
+    return rows
+
+
+def plot_curves(output: str, rows: List[Dict[str, str]]):
+    """
+    Draw success-rate, time-per-timestep and throughput over the agent count,
+    one figure per map, one line per (shape, size range).
+    """
+    try:
+        import matplotlib
+        matplotlib.use('Agg')
+        import matplotlib.pyplot
+    except ImportError:
+        LOGGER.warning('matplotlib is not installed, skipping curves (summary.csv files are written)')
+        return
+
+    metrics = [
+        ('success_rate', 'success rate'),
+        ('mean_time_per_timestep', 'time per timestep (ms)'),
+        ('mean_throughput', 'throughput (agent moves / s)'),
+    ]
+    line_styles = {'square': '-', 'circle': '--'}
+
+    for map_file in sorted({row['map'] for row in rows}):
+        map_rows = [row for row in rows if row['map'] == map_file]
+        fig, axes = matplotlib.pyplot.subplots(1, len(metrics), figsize=(6 * len(metrics), 4.5))
+        for ax, (key, label) in zip(axes, metrics):
+            for shape, sizes in sorted({(row['shape'], row['sizes']) for row in map_rows}):
+                points = sorted(
+                    (int(row['agents']), float(row[key]))
+                    for row in map_rows
+                    if row['shape'] == shape and row['sizes'] == sizes and row[key] != ''
+                )
+                if points:
+                    ax.plot([p[0] for p in points], [p[1] for p in points],
+                            line_styles.get(shape, '-'), marker='o', label=f'{shape} {sizes}')
+            ax.set_xscale('log')
+            ax.set_xlabel('agents')
+            ax.set_ylabel(label)
+            ax.grid(True, alpha=0.3)
+            if key != 'success_rate':
+                ax.set_yscale('log')
+        axes[0].legend(fontsize='small')
+        fig.suptitle(map_file)
+        fig.tight_layout()
+        path = os.path.join(output, os.path.splitext(map_file)[0] + '.png')
+        fig.savefig(path)
+        matplotlib.pyplot.close(fig)
+        LOGGER.info(f'Saved {path}')
+
+
+if __name__ == "__main__":
+    args = parse_arguments()
+    check_arguments_validity(args)
+
+    logging.basicConfig(
+        format="[%(levelname)s] %(message)s",
+        level=(logging.DEBUG if args.verbose else logging.INFO),
+    )
+
+    if not args.plot_only:
+        runs = run_sweep(args)
+        for shape in sorted({run['shape'] for run in runs}):
+            shape_runs = [run for run in runs if run['shape'] == shape]
+            write_csv(os.path.join(args.output, shape, 'runs.csv'), RUN_FIELDS, shape_runs)
+            write_csv(os.path.join(args.output, shape, 'summary.csv'), SUMMARY_FIELDS, summarize(shape_runs))
+
+    plot_curves(args.output, read_summaries(args.output))
@@ -1,3 +0,0 @@
-#include <graph.hpp>
-
-bool checkIfNodeExistInRadiusOnGrid(Graph *G, int x, int y, float r);
\ No newline at end of file
@@ -1,10 +1,12 @@
 #include <getopt.h>
 
 #include <default_params.hpp>
+#include <grid_bfs.hpp>
 #include <iostream>
 #include <mapf_problem.hpp>
 #include <mapf_solver.hpp>
 #include <getopt.h>
+#include <queue>
 #include <random>
 #include <vector>
 #include <fstream>
@@ -18,15 +20,84 @@ void printHelp()
             << "  -h --help                     help\n"
             << "  -s --solver [SOLVER_NAME]     solver (LAPIBT)\n"
             << "  -n --trials [int]             number of trials to execute\n"
+            << "  -b --check-bfs                compare the distance tables of GridBFS with a queue BFS and exit\n"
             << std::endl;
 }
 
+// distance table as computed before GridBFS, for checkBFS()
+void queueBFS(Grid *grid, Node *goal, const AgentShape &shape, int unreachable,
+              std::vector<int> &table)
+{
+  table.assign(grid->getNodesSize(), unreachable);
+  table[goal->id] = 0;
+  std::queue<Node *> OPEN;
+  OPEN.push(goal);
+  while (!OPEN.empty()) {
+    Node *n = OPEN.front();
+    OPEN.pop();
+    for (auto m : n->neighbor) {
+      if (!fitsShape(grid, m->pos.x, m->pos.y, shape)) continue;
+      if (table[n->id] + 1 >= table[m->id]) continue;
+      table[m->id] = table[n->id] + 1;
+      OPEN.push(m);
+    }
+  }
+}
+
+// GridBFS::run and runBatch against queueBFS, from the starts and goals of the instance, for
+// every footprint and for the limit of the instance and a small one; 1 on a mismatch
+int checkBFS(LargeAgentsMapfProblem &P)
+{
+  Grid *grid = P.getGrid();
+  std::vector<Node *> goals;
+  for (int i = 0; i < P.getNum(); ++i) {
+    goals.push_back(P.getStart(i));
+    goals.push_back(P.getGoal(i));
+  }
+  std::vector<AgentShape> footprints;
+  for (auto &s : P.getAgentShapes())
+    if (std::find(footprints.begin(), footprints.end(), s.footprint()) == footprints.end())
+      footprints.push_back(s.footprint());
+
+  int mismatches = 0;
+  for (auto &shape : footprints) {
+    GridBFS bfs(grid, P.getCSR(), shape);
+    for (int unreachable : {P.getMaxTimestep() + 1, 10}) {
+      int run_mismatches = 0;
+      int batch_mismatches = 0;
+      std::vector<int> expected, table;
+      std::vector<std::vector<int>> batch(GridBFS::MAX_BATCH);
+      std::vector<std::vector<int> *> tables;
+      for (auto &t : batch) tables.push_back(&t);
+      for (size_t first = 0; first < goals.size(); first += GridBFS::MAX_BATCH) {
+        const int count = std::min(goals.size() - first, size_t(GridBFS::MAX_BATCH));
+        std::vector<int> ids;
+        for (int k = 0; k < count; ++k) ids.push_back(goals[first + k]->id);
+        bfs.runBatch(ids.data(), count, unreachable, tables.data());
+        for (int k = 0; k < count; ++k) {
+          queueBFS(grid, goals[first + k], shape, unreachable, expected);
+          bfs.run(ids[k], unreachable, table);
+          if (table != expected) ++run_mismatches;
+          if (batch[k] != expected) ++batch_mismatches;
+        }
+      }
+      std::cout << "footprint=" << getShapeName(shape.kind) << " " << getSizeName(shape)
+                << ", unreachable=" << unreachable << ", goals=" << goals.size()
+                << ", run_mismatches=" << run_mismatches
+                << ", batch_mismatches=" << batch_mismatches << std::endl;
+      mismatches += run_mismatches + batch_mismatches;
+    }
+  }
+  return mismatches == 0 ? 0 : 1;
+}
+
 int main(int argc, char *argv[])
 {
   std::string instance_file;
   std::string output_file = DEFAULT_OUTPUT_FILE;
   std::string solver_name;
   int number_of_trials = 10;
+  bool check_bfs = false;
 
   bool verbose = false;
   char *argv_copy[argc + 1];
@@ -40,6 +111,7 @@ int main(int argc, char *argv[])
       {"solver", required_argument, 0, 's'},
       {"trials", required_argument, 0, 'n'},
       {"verbose", no_argument, 0, 'v'},
+      {"check-bfs", no_argument, 0, 'b'},
       {0, 0, 0, 0},
   };
 
@@ -49,7 +121,7 @@ int main(int argc, char *argv[])
 
   opterr = 0; // ignore getopt error
 
-  while ((opt = getopt_long(argc, argv, "i:o:s:vn:", longopts,
+  while ((opt = getopt_long(argc, argv, "i:o:s:vn:b", longopts,
                             &longindex)) != -1)
   {
     switch (opt)
@@ -72,6 +144,9 @@ int main(int argc, char *argv[])
     case 'n':
       std::sscanf(optarg, "%d", &number_of_trials);
       break;
+    case 'b':
+      check_bfs = true;
+      break;
     default:
       break;
     }
@@ -86,6 +161,7 @@ int main(int argc, char *argv[])
   }
 
   auto P = LargeAgentsMapfProblem(instance_file);
+  if (check_bfs) return checkBFS(P);
   int number_of_agents = P.getNum();
   std::vector<float> random_radiuses = P.getMinMaxRadiuses();
   int while_iterations = number_of_trials;
@@ -4,7 +4,12 @@
 #include <iostream>
 #include <mapf_problem.hpp>
 #include <mapf_solver.hpp>
+#include <lifelong.hpp>
+#include <server.hpp>
+#include <batch.hpp>
+#include <portfolio.hpp>
 #include <getopt.h>
+#include <memory>
 #include <random>
 #include <vector>
 
@@ -26,7 +31,40 @@ void printHelp()
             << "  -k --kSteps [INT]             k-steps parameter of LA-PIBT"
                " (default=1)\n"
             << "  -x --seed [INT]               random generator seed (only "
-               "used when not set in the instance file)"
+               "used when not set in the instance file)\n"
+            << "  -B --timestep-budget [INT]    planning deadline of a single "
+               "timestep (ms), agents wait once it is exceeded\n"
+            << "  -w --stall-window [INT]       restart with perturbed priorities "
+               "after this many timesteps without progress towards the goals\n"
+            << "  -c --conflict-backend [NAME]  collision checks of LA-PIBT, "
+               "pairwise or raster (per-timestep occupancy bitsets)\n"
+            << "  -e --escape [NAME]            escape of LA-PIBT children, bfs "
+               "(default) or greedy\n"
+            << "  -H --distance-oracle [NAME]   goal distances, exact (a table per "
+               "agent, default) or hierarchical (clusters and portals, for large maps)\n"
+            << "  -N --lns [INT]                improve a solved instance by large "
+               "neighbourhood search for up to this many ms\n"
+            << "  -S --stats [FILE_PATH]        write solver counters and "
+               "per-timestep times to file\n"
+            << "  -R --trace [FILE_PATH]        write a timeline of solver "
+               "phases in Chrome trace-event format\n"
+            << "  -l --lifelong                 lifelong MAPF, new tasks are "
+               "assigned to agents that reached their goals (task_num, "
+               "task_frequency, task_file in the instance file)\n"
+            << "  -W --distance-table-workers [INT]  compute distance tables of "
+               "new goals on background threads (0: all cores)\n"
+            << "  -C --distance-table-cache [INT]  keep distance tables of up to "
+               "this many MB for reuse, least recently used are evicted\n"
+            << "  -U --serve [SOCKET_PATH]      keep running and solve requests "
+               "sent to a Unix domain socket, see README\n"
+            << "  -M --batch [FILE_PATH|DIR]    solve every instance of a manifest "
+               "file or directory, -o is the output directory\n"
+            << "  -J --jobs [INT]               instances solved in parallel in "
+               "batch mode (default: all cores)\n"
+            << "  -K --portfolio [INT]          run this many solvers with different "
+               "seeds and inheritanceDepth at once, the first valid plan wins\n"
+            << "  -Y --portfolio-best           with -K, wait for all solvers and "
+               "keep the valid plan with the smallest SOC"
             << std::endl;
 }
 
@@ -51,6 +89,22 @@ int main(int argc, char *argv[])
       {"make-scen", no_argument, 0, 'P'},
       {"inheritanceDepth", required_argument, 0, 'D'},
       {"seed", required_argument, 0, 'x'},
+      {"stats", required_argument, 0, 'S'},
+      {"trace", required_argument, 0, 'R'},
+      {"timestep-budget", required_argument, 0, 'B'},
+      {"stall-window", required_argument, 0, 'w'},
+      {"conflict-backend", required_argument, 0, 'c'},
+      {"escape", required_argument, 0, 'e'},
+      {"distance-oracle", required_argument, 0, 'H'},
+      {"lns", required_argument, 0, 'N'},
+      {"lifelong", no_argument, 0, 'l'},
+      {"distance-table-workers", required_argument, 0, 'W'},
+      {"distance-table-cache", required_argument, 0, 'C'},
+      {"serve", required_argument, 0, 'U'},
+      {"batch", required_argument, 0, 'M'},
+      {"jobs", required_argument, 0, 'J'},
+      {"portfolio", required_argument, 0, 'K'},
+      {"portfolio-best", no_argument, 0, 'Y'},
       {0, 0, 0, 0},
   };
 
@@ -60,12 +114,29 @@ int main(int argc, char *argv[])
   int inheritanceDepth = DEFAULT_INHERITANCE_DEPTH;
   bool is_seed = false;
   int seed = 0;
+  std::string stats_file;
+  std::string trace_file;
+  int timestep_budget = 0;
+  int stall_window = 0;
+  ConflictBackend conflict_backend = ConflictBackend::PAIRWISE;
+  EscapeSearch escape_search = EscapeSearch::BFS;
+  DistanceOracle distance_oracle = DistanceOracle::EXACT;
+  int lns_time_limit = 0;
+  bool lifelong = false;
+  int distance_table_workers = -1;
+  int distance_table_cache_mb = 0;
+  std::string socket_path;
+  std::string batch;
+  int jobs = 0;
+  bool is_output = false;
+  int portfolio = 0;
+  bool portfolio_best = false;
   // command line args
   int opt, longindex;
 
   opterr = 0; // ignore getopt error
 
-  while ((opt = getopt_long(argc, argv, "i:o:s:vhPT:L", longopts,
+  while ((opt = getopt_long(argc, argv, "i:o:s:vhPT:LD:x:S:R:B:w:c:e:H:N:lW:C:U:M:J:K:Y", longopts,
                             &longindex)) != -1)
   {
     switch (opt)
@@ -78,6 +149,7 @@ int main(int argc, char *argv[])
       break;
     case 'o':
       output_file = std::string(optarg);
+      is_output = true;
       break;
     case 'h':
       printHelp();
@@ -101,11 +173,124 @@ int main(int argc, char *argv[])
       seed = std::atoi(optarg);
       is_seed = true;
       break;
+    case 'S':
+      stats_file = std::string(optarg);
+      break;
+    case 'R':
+      trace_file = std::string(optarg);
+      break;
+    case 'B':
+      timestep_budget = std::atoi(optarg);
+      break;
+    case 'w':
+      stall_window = std::atoi(optarg);
+      break;
+    case 'c':
+      if (!parseConflictBackend(optarg, conflict_backend))
+      {
+        std::cout << "error@mapf: unknown conflict backend " << optarg << std::endl;
+        return 1;
+      }
+      break;
+    case 'e':
+      if (!parseEscapeSearch(optarg, escape_search))
+      {
+        std::cout << "error@mapf: unknown escape " << optarg << std::endl;
+        return 1;
+      }
+      break;
+    case 'H':
+      if (!parseDistanceOracle(optarg, distance_oracle))
+      {
+        std::cout << "error@mapf: unknown distance oracle " << optarg << std::endl;
+        return 1;
+      }
+      break;
+    case 'N':
+      lns_time_limit = std::atoi(optarg);
+      break;
+    case 'l':
+      lifelong = true;
+      break;
+    case 'W':
+      distance_table_workers = std::atoi(optarg);
+      break;
+    case 'C':
+      distance_table_cache_mb = std::atoi(optarg);
+      break;
+    case 'U':
+      socket_path = std::string(optarg);
+      break;
+    case 'M':
+      batch = std::string(optarg);
+      break;
+    case 'J':
+      jobs = std::atoi(optarg);
+      break;
+    case 'K':
+      portfolio = std::atoi(optarg);
+      break;
+    case 'Y':
+      portfolio_best = true;
+      break;
     default:
       break;
     }
   }
 
+  // of a single run, batch and server mode have their own cache
+  std::unique_ptr<DistanceTableCache> distance_table_cache;
+
+  // options of the solver, or of every solver of a portfolio, batch or server
+  std::function<void(LargeAgentsMAPFSolver *)> configureSolver = [&](LargeAgentsMAPFSolver *solver)
+  {
+    solver->setLogShort(log_short);
+    solver->setTimestepBudget(timestep_budget);
+    solver->setStallWindow(stall_window);
+    solver->setConflictBackend(conflict_backend);
+    solver->setEscapeSearch(escape_search);
+    solver->setDistanceOracle(distance_oracle);
+    solver->setLNS(lns_time_limit, DEFAULT_LNS_NEIGHBORHOOD_SIZE);
+    if (distance_table_workers != -1)
+      solver->setDistanceTableWorkers(distance_table_workers);
+    if (distance_table_cache)
+      solver->setDistanceTableCache(distance_table_cache.get());
+  };
+
+  if (socket_path.length() != 0)
+  {
+    const int cache_mb = distance_table_cache_mb > 0 ? distance_table_cache_mb
+                                                     : DEFAULT_DISTANCE_TABLE_CACHE_MB;
+    LargeAgentsMAPFServer server(socket_path, size_t(cache_mb) << 20, configureSolver);
+    return server.run() ? 0 : 1;
+  }
+
+  if (batch.length() != 0)
+  {
+    const int cache_mb = distance_table_cache_mb > 0 ? distance_table_cache_mb
+                                                     : DEFAULT_DISTANCE_TABLE_CACHE_MB;
+    const std::string output_dir = is_output ? output_file : DEFAULT_BATCH_OUTPUT_DIR;
+    LargeAgentsMAPFBatch batch_solver(solver_name, inheritanceDepth, max_comp_time,
+                                      configureSolver, size_t(cache_mb) << 20, jobs);
+    auto instances = LargeAgentsMAPFBatch::listInstances(batch);
+    auto results = batch_solver.run(instances, output_dir);
+    batch_solver.writeSummary(results, output_dir + "/summary.csv");
+
+    int solved = 0, valid = 0;
+    for (auto &r : results)
+    {
+      solved += r.solved;
+      valid += r.valid;
+    }
+    std::cout << "instances=" << results.size() << ", solved=" << solved
+              << ", valid=" << valid << ", maps=" << batch_solver.getNumMaps()
+              << ", distance_table_cache_hits=" << batch_solver.getCache().getHits()
+              << ", misses=" << batch_solver.getCache().getMisses() << std::endl;
+    if (verbose)
+      std::cout << "save results in " << output_dir << std::endl;
+    return 0;
+  }
+
   if (instance_file.length() == 0)
   {
     std::cout << "specify instance file using -i [INSTANCE-FILE], e.g.,"
@@ -128,12 +313,91 @@ int main(int argc, char *argv[])
     return 0;
   }
 
+  // outlives the solvers, whose workers may still use it
+  if (distance_table_cache_mb > 0)
+    distance_table_cache =
+        std::make_unique<DistanceTableCache>(size_t(distance_table_cache_mb) << 20);
+
+  if (portfolio > 0)
+  {
+    // the trace is written by one thread only, lifelong goals are given to one solver
+    if (lifelong || trace_file.length() != 0)
+    {
+      std::cout << "error@mapf: -K cannot be combined with -l or -R" << std::endl;
+      return 1;
+    }
+    LargeAgentsMAPFPortfolio portfolio_solver(&P, solver_name, portfolio, seed,
+                                              inheritanceDepth, portfolio_best, configureSolver);
+    portfolio_solver.solve();
+    if (stats_file.length() != 0)
+      portfolio_solver.makeStats(stats_file);
+    std::cout << (portfolio_solver.succeed() ? "Solved\n" : "Failed to converge\n");
+    portfolio_solver.printResult();
+    portfolio_solver.makeLog(output_file);
+    if (verbose)
+      std::cout << "save result as " << output_file << std::endl;
+    return 0;
+  }
+
   //   solve
   auto solver = getSolver(solver_name, &P, inheritanceDepth, verbose, argc, argv_copy);
-  solver->setLogShort(log_short);
+  configureSolver(solver.get());
+
+  std::unique_ptr<TraceWriter> trace;
+  if (trace_file.length() != 0)
+  {
+    trace = std::make_unique<TraceWriter>();
+    solver->setTrace(trace.get());
+  }
+
+  if (lifelong)
+  {
+    LifelongLargeAgentsMAPF lifelong_mapf(&P, solver.get());
+    lifelong_mapf.solve();
+
+    if (stats_file.length() != 0)
+      solver->makeStats(stats_file);
+
+    bool valid;
+    {
+      TraceSpan span(trace.get(), "validate", "validation");
+      valid = solver->getSolution().validateWithoutGoals(&P);
+    }
+
+    if (trace)
+      trace->write(trace_file);
+
+    if (!valid)
+    {
+      std::cout << "error@mapf: invalid results" << std::endl;
+      lifelong_mapf.makeLog(output_file);
+      return 0;
+    }
+
+    std::cout << (lifelong_mapf.succeed() ? "Solved\n" : "Stopped\n");
+    lifelong_mapf.printResult();
+    lifelong_mapf.makeLog(output_file);
+    if (verbose)
+      std::cout << "save result as " << output_file << std::endl;
+    return 0;
+  }
+
   solver->solve();
 
-  if (solver->succeed() && !solver->getSolution().validate(&P))
+  if (stats_file.length() != 0)
+    solver->makeStats(stats_file);
+
+  bool valid = false;
+  if (solver->succeed())
+  {
+    TraceSpan span(trace.get(), "validate", "validation");
+    valid = solver->getSolution().validate(&P);
+  }
+
+  if (trace)
+    trace->write(trace_file);
+
+  if (solver->succeed() && !valid)
   {
     solver->makeLog(output_file);
     std::cout << "error@mapf: invalid results" << std::endl;
@@ -0,0 +1,58 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "distance_table_cache.hpp"
+#include "grid_store.hpp"
+#include "mapf_solver.hpp"
+#include "thread_pool.hpp"
+
+/*
+ * Solve many instance files in one process.
+ * Maps and distance tables are shared by all instances, instances are solved
+ * concurrently by a thread pool. Every instance gets its own result file in the
+ * output directory, summary.csv has one row per instance. Every solver gets the
+ * options of configure, e.g. those of the command line.
+ */
+class LargeAgentsMAPFBatch
+{
+public:
+    struct Result
+    {
+        std::string instance;
+        bool solved = false;
+        bool valid = false;
+        int soc = 0;
+        int makespan = 0;
+        int comp_time = 0;
+        int preprocessing_comp_time = 0;
+    };
+
+private:
+    const std::string solver_name;
+    const int inheritanceDepth;
+    const int max_comp_time; // -1, use max_comp_time of the instance file
+    const std::function<void(LargeAgentsMAPFSolver *)> configure; // called on every solver
+    GridStore maps;
+    DistanceTableCache cache;
+    ThreadPool workers;
+
+    Result solve(const std::string &instance_file, const std::string &output_file);
+
+public:
+    LargeAgentsMAPFBatch(const std::string &solver_name, int inheritanceDepth,
+                         int max_comp_time,
+                         std::function<void(LargeAgentsMAPFSolver *)> configure, size_t cache_bytes,
+                         int num_threads);
+
+    // instance files of a directory (recursively, *.txt) or listed in a manifest file
+    static std::vector<std::string> listInstances(const std::string &manifest_or_dir);
+
+    std::vector<Result> run(const std::vector<std::string> &instances,
+                            const std::string &output_dir);
+    void writeSummary(const std::vector<Result> &results, const std::string &summary_file) const;
+
+    const DistanceTableCache &getCache() const { return cache; }
+    int getNumMaps() { return maps.size(); }
+};
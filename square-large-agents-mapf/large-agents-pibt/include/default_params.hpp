@@ -8,3 +8,7 @@ static constexpr int DEFAULT_MAX_COMP_TIME = 60000;
 static constexpr float DEFAULT_TASK_FREQUENCY = 1;
 static constexpr int DEFAULT_TASK_NUM = 10;
 static constexpr int DEFAULT_INHERITANCE_DEPTH = 15;
+static constexpr int DEFAULT_TRACE_CAPACITY = 1 << 20; // events kept by the trace ring
+static constexpr int DEFAULT_DISTANCE_TABLE_CACHE_MB = 256; // cache of the server mode
+static constexpr int DEFAULT_LNS_NEIGHBORHOOD_SIZE = 8; // agents replanned together by -N
+static const std::string DEFAULT_BATCH_OUTPUT_DIR = "./batch-results";
@@ -0,0 +1,95 @@
+#pragma once
+#include <graph.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "grid_bfs.hpp"
+#include "grid_csr.hpp"
+
+// what pathDist() of the solvers looks up
+enum class DistanceOracle
+{
+    EXACT,        // a full distance table per agent
+    HIERARCHICAL, // HierarchicalDistanceOracle
+};
+
+// "exact" or "hierarchical", false if unknown
+bool parseDistanceOracle(const std::string &name, DistanceOracle &oracle);
+std::string getDistanceOracleName(DistanceOracle oracle);
+
+/*
+ * Goal distances for maps too large for a full table per agent.
+ *
+ * Per shape class, the map is cut into clusters of CLUSTER x CLUSTER cells. Every run of
+ * open cells along the border of two clusters gets one portal on each side, in its middle,
+ * and every cluster keeps the distances inside of it from each of its portals to its cells.
+ *
+ * Per agent, only a BFS from the goal over the window of cells within NEAR_RADIUS, and
+ * the distances from the goal to all portals by Dijkstra over the portal graph, seeded by
+ * the portals in the window, are kept. The distance of a cell is the shorter of the one in
+ * the window and the best route via a portal of its cluster:
+ *   - exact if not longer than NEAR_RADIUS, the window covers every such path,
+ *   - otherwise the length of a path through the portals, so never below the exact one.
+ * Every cell that is not the goal has a neighbour one step closer, a gradient without
+ * local minima, which is what PIBT follows. Unreachable cells get the value of the tables.
+ */
+class HierarchicalDistanceOracle
+{
+public:
+    static constexpr int CLUSTER_SHIFT = 4;
+    static constexpr int CLUSTER = 1 << CLUSTER_SHIFT;
+    static constexpr int NEAR_RADIUS = CLUSTER;
+
+private:
+    static constexpr uint16_t FAR = UINT16_MAX; // not within a cluster or window
+
+    struct Abstraction
+    {
+        struct Cluster
+        {
+            std::vector<int> portals; // of this cluster
+            size_t first = 0;         // its block of local, one CLUSTER^2 row per portal
+        };
+        struct Edge
+        {
+            int to;
+            int cost;
+        };
+        std::vector<Cluster> clusters;         // row-major
+        std::vector<int> portal_node;          // portal -> node id
+        std::vector<std::vector<Edge>> edges;  // portal -> other portals
+        std::vector<uint16_t> local;           // portal row -> cell of its cluster -> steps
+        size_t getMemory() const;
+    };
+
+    struct GoalDistances
+    {
+        int shape_class = -1;
+        int x0 = 0, y0 = 0, w = 0, h = 0; // window
+        std::vector<uint16_t> near;       // window cell -> steps from the goal
+        std::vector<int> portal_dist;     // portal -> steps from the goal
+    };
+
+    const GridCSR &csr;
+    const int width;
+    const int height;
+    const int columns; // of clusters
+    const int rows;
+    const int unreachable;
+
+    std::vector<std::unique_ptr<Abstraction>> abstractions; // per shape class
+    std::vector<GoalDistances> goals;                       // per agent
+
+    std::unique_ptr<Abstraction> buildAbstraction(const GridBFS &bfs) const;
+
+public:
+    HierarchicalDistanceOracle(Grid *_grid, const GridCSR &_csr, int agents, int shape_classes,
+                               int _unreachable);
+
+    // agent i of shape_class, whose open cells are those of bfs, heads to goal
+    void setGoal(int i, int shape_class, const GridBFS &bfs, int goal);
+    int getDistance(int i, int id) const;
+    size_t getMemory() const; // bytes of the abstractions and the distances of all agents
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <fstream>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "shapes.hpp"
+
+/*
+ * Goal distance tables shared by solver instances, bounded by a byte budget.
+ *
+ * A table depends on the map, the goal, the footprint of the agent (shape class,
+ * AgentShape::footprint) and max_timestep (value of unreachable nodes).
+ * The least recently used tables are evicted once the budget is exceeded and
+ * recomputed on their next use. Thread-safe, a miss is computed outside of the lock.
+ */
+class DistanceTableCache
+{
+public:
+    using Table = std::vector<int>;
+    struct Key
+    {
+        std::string map_file;
+        int goal;
+        AgentShape footprint;
+        int max_timestep;
+        bool operator==(const Key &other) const
+        {
+            return goal == other.goal && footprint == other.footprint &&
+                   max_timestep == other.max_timestep && map_file == other.map_file;
+        }
+    };
+
+private:
+    struct KeyHash
+    {
+        size_t operator()(const Key &key) const;
+    };
+    struct Entry
+    {
+        Key key;
+        Table table;
+    };
+
+    const size_t budget;                  // bytes
+    size_t bytes = 0;                     // bytes of cached tables
+    std::list<Entry> entries;             // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+    mutable std::mutex mutex;
+
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+
+    static size_t tableBytes(const Table &table) { return table.size() * sizeof(int); }
+    void evict(); // until the budget is kept, call with the lock held
+
+public:
+    explicit DistanceTableCache(size_t budget_bytes);
+
+    // copy the table of key into table, compute(table) on a miss
+    void get(const Key &key, Table &table, const std::function<void(Table &)> &compute);
+
+    long long getHits() const;
+    long long getMisses() const;
+    long long getEvictions() const;
+    size_t getBytes() const;
+    size_t getBudget() const { return budget; }
+
+    void write(std::ostream &log) const; // key=value lines for the result file
+};
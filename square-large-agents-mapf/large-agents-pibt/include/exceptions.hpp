@@ -5,4 +5,15 @@ class too_high_compute_time_exception : public std::exception {
         const std::string message() {
             return  "Maximum computation time exceeded. ";
         }
+};
+
+// an instance that cannot be read, thrown instead of halting by problems of a long-running process
+class invalid_instance_exception : public std::exception {
+    private:
+        const std::string msg;
+    public:
+        explicit invalid_instance_exception(const std::string &_msg) : msg(_msg) {}
+        const std::string message() {
+            return msg;
+        }
 };
\ No newline at end of file
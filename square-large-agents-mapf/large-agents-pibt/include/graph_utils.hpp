@@ -1,3 +1,5 @@
 #include <graph.hpp>
+#include "shapes.hpp"
 
-bool checkIfNodeExistInRadiusOnGrid(Graph *G, int x, int y, float r);
\ No newline at end of file
+// SquareShape::fits
+bool checkIfNodeExistInRadiusOnGrid(Graph *G, int x, int y, float r);
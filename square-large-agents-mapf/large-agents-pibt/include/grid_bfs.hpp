@@ -0,0 +1,56 @@
+#pragma once
+#include <graph.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "grid_csr.hpp"
+#include "shapes.hpp"
+
+/*
+ * Breadth-first search for goal distance tables of one footprint on a 4-connected grid.
+ *
+ * The cells where the footprint fits are computed once, as a bitset of rows padded to
+ * 64-bit words (node id = y * width + x, bit x of row y). A search then expands level by
+ * level: the next frontier of a row is the frontier shifted left and right within the row,
+ * or'ed with the rows above and below, masked by the open cells not visited yet. Only the
+ * band of rows the frontier spans is touched, and a cell reached is written to the table
+ * from its word and bit, without a division.
+ *
+ * runBatch() searches from up to 64 goals at once, with one bit per goal in every cell: a
+ * cell's frontier word is or'ed into its open neighbours, so goals that reach a cell at the
+ * same level share the visit of its edges.
+ *
+ * Same distances as a BFS over Node::neighbor restricted to the open cells, the goal is
+ * expanded even if the footprint does not fit there. The connected components of the open
+ * cells are labelled once, so whether a goal is reachable is known without a search.
+ * Read-only after construction, run() and runBatch() are thread-safe.
+ */
+class GridBFS
+{
+private:
+    const int width;
+    const int height;
+    const int words;                // per row
+    std::vector<uint64_t> open;     // row * words + word, bit set where the footprint fits
+    int open_cells = 0;
+    // for runBatch(), cells with a border of one blocked cell, (y + 1) * (width + 2) + x + 1
+    std::vector<uint8_t> padded_open;
+    std::vector<int> padded_id; // padded cell -> node id
+    std::vector<int> padded_component; // padded cell -> component of the open cells, -1 if blocked
+
+public:
+    GridBFS(Grid *grid, const GridCSR &csr, const AgentShape &shape);
+
+    // table[id] = steps from goal, unreachable for cells not reached in fewer steps
+    void run(int goal, int unreachable, std::vector<int> &table) const;
+    // *tables[k] as by run(goals[k], ...), for k < count <= MAX_BATCH
+    static constexpr int MAX_BATCH = 64;
+    void runBatch(const int *goals, int count, int unreachable,
+                  std::vector<int> *const *tables) const;
+
+    // run(goal) reaches id if unreachable is large enough
+    bool isConnected(int id, int goal) const;
+
+    bool isOpen(int x, int y) const { return (open[y * words + (x >> 6)] >> (x & 63)) & 1; }
+    int getOpenCells() const { return open_cells; }
+};
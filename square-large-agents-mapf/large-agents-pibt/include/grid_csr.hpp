@@ -0,0 +1,51 @@
+#pragma once
+#include <graph.hpp>
+#include <cstddef>
+#include <vector>
+
+/*
+ * Adjacency and coordinates of a graph in flat arrays indexed by node id.
+ *
+ * Node::neighbor is a vector per node and Node::pos sits behind a pointer, both scattered
+ * over the heap. Here the neighbours of all nodes are stored back to back in one array
+ * (compressed sparse row), in the order of Node::neighbor, so loops over a map walk
+ * contiguous memory. Ids without a node (obstacles) have no neighbours.
+ *
+ * Built once per problem from its graph, read-only and thread-safe afterwards.
+ */
+class GridCSR
+{
+private:
+    std::vector<int> offsets;   // node id -> first neighbour in adjacency, one more at the end
+    std::vector<int> adjacency; // neighbour ids
+    std::vector<int> xs;        // node id -> x
+    std::vector<int> ys;        // node id -> y
+    Nodes nodes;                // node id -> node, nullptr if none
+
+public:
+    explicit GridCSR(Graph *G);
+
+    struct Neighbors
+    {
+        const int *first;
+        const int *last;
+        const int *begin() const { return first; }
+        const int *end() const { return last; }
+        int size() const { return last - first; }
+        int operator[](int k) const { return first[k]; }
+    };
+
+    int size() const { return nodes.size(); } // number of ids, as Graph::getNodesSize()
+    bool existNode(int id) const { return nodes[id] != nullptr; }
+    Node *getNode(int id) const { return nodes[id]; }
+    Neighbors getNeighbors(int id) const
+    {
+        return {adjacency.data() + offsets[id], adjacency.data() + offsets[id + 1]};
+    }
+    int getDegree(int id) const { return offsets[id + 1] - offsets[id]; }
+    bool isNeighbor(int u, int v) const; // v is adjacent to u
+    int getX(int id) const { return xs[id]; }
+    int getY(int id) const { return ys[id]; }
+    float euclideanDist(int u, int v) const;
+    size_t getMemory() const; // bytes of the arrays
+};
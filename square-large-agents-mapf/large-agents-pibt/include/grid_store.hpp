@@ -0,0 +1,27 @@
+#pragma once
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <graph.hpp>
+
+/*
+ * Maps loaded once and shared by problems, e.g. in batch and server mode.
+ * Thread-safe, grids live as long as the store.
+ */
+class GridStore
+{
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<Grid>> grids; // by map_file
+
+    // width/height header, "map", then height rows of width cells, as Grid expects
+    static bool isValidMap(std::istream &file);
+
+public:
+    // nullptr if the file does not exist or is not a valid map
+    Grid *get(const std::string &map_file);
+    int size();
+};
@@ -1,7 +1,10 @@
 #include "mapf_solver.hpp"
+#include "solver_stats.hpp"
 #include <unordered_set>
-#include <map>
+#include <memory>
 
+// Shape is SquareShape, CircleShape or MixedShape, see shapes.hpp
+template <class Shape>
 class LAPIBT : public LargeAgentsMAPFSolver
 {
 public:
@@ -16,7 +19,8 @@ private:
         int elapsed;                                   // eta
         double init_d;                                 // initial distance
         float tie_breaker;                              // epsilon, tie-breaker
-        float size;                                     // Size of border of square an agent
+        float size;                                     // Size of the agent, the larger side
+        AgentShape shape;                               // see Shape
 
         void wait() {
             path.insert(
@@ -28,12 +32,71 @@ private:
 
     struct PathState
     {
+        Agent* agent;
         size_t size;
         Node* last_node_in_path;
     };
 
+    std::vector<Agent*> allAgents;
     std::unordered_set<Agent*> setOfAgentsInConflict;
     int inheritanceDepth;
+    int timestep = 0;
+    SolverStats stats;
+    Time::time_point timestep_deadline; // end of the timestep budget of the current timestep
+
+    bool overTimestepBudget() const;
+    std::vector<PathState> step_paths; // every path at the start of step(), restored if it throws
+
+    // restart with perturbation, when the sum of distances to goals stalls
+    int initial_inheritanceDepth;
+    int best_progress = -1;            // smallest sum of distances since the last restart, -1 if unset
+    int last_progress_timestep = 0;    // timestep of best_progress
+    std::vector<int> window_dists;     // distance of every agent at last_progress_timestep
+    std::vector<int> restart_timesteps;
+    void checkStall(const Config &configuration);
+    void restart(const Config &configuration);
+
+    // ConflictBackend::RASTER, the paths of all agents but those in setOfAgentsInConflict;
+    // every change of a path or of the set is announced by pathChanged()
+    std::unique_ptr<OccupancyRaster> raster;
+    std::vector<Agent*> changed_agents;
+    std::vector<char> is_changed; // agent id -> in changed_agents
+    void pathChanged(Agent *agent);
+    void syncRaster(Agent *agent); // without the last node of agent, the candidate move
+
+    // scratch of the inheritance, grown once and reused so that it does not allocate afterwards.
+    // Every solveInheritanceConflict/escapeInheritanceConflict call on the stack owns a frame of
+    // saved_paths and escape_nodes above the one of its caller
+    std::vector<PathState> saved_paths;          // states before conflict, one per agent and frame
+    Nodes escape_nodes;                          // border nodes around the parent, or the route
+    std::vector<std::vector<unsigned>> visited;  // nesting level -> node id -> generation
+    unsigned visited_generation = 0;
+    unsigned nextVisitedGeneration(int level);
+    void restorePaths(size_t frame);             // and drops the frame
+    void mergePaths(size_t frame, size_t from);  // saved paths from `from` on join the frame
+    bool isSaved(size_t frame, size_t end, const Agent *agent) const;
+
+    // a single step of an escape to v, with the waits and inheritances it causes; unless MOVED,
+    // the child is back where it was
+    enum class EscapeStep { MOVED, COLLISION, BLOCKED };
+    EscapeStep stepEscape(Agent *child_agent, Agent *parent_agent, Node *v, size_t frame,
+                          const std::vector<Agent *> &allAgents);
+    bool escapeGreedily(Agent *child_agent, Agent *parent_agent, const std::vector<Agent *> &allAgents);
+
+    // EscapeSearch::BFS, one search at a time
+    static constexpr int MAX_ESCAPE_SEARCHES = 4; // per escape, each after a step that failed
+    std::vector<int> escape_queue;      // node ids
+    std::vector<int> escape_pred;       // node id -> predecessor in the search
+    std::vector<int> escape_depth;      // node id -> steps from the child
+    std::vector<unsigned> escape_seen;  // node id -> search it was reached in
+    unsigned escape_search_generation = 0;
+    bool isClearOfConflict(const Agent *child_agent, Node *v) const;
+    // appends the nodes from the child to the nearest node clear of the agents in conflict and
+    // off the way of the parent, or else the nearest clear one, avoiding the nodes stamped with
+    // generation on level and never moving towards the parent while overlapping it
+    bool findEscapeRoute(Agent *child_agent, Agent *parent_agent, int level, unsigned generation,
+                         int max_steps);
+    bool escapeAlongRoute(Agent *child_agent, Agent *parent_agent, const std::vector<Agent *> &allAgents);
 
     // option
     bool disable_dist_init = false;
@@ -42,17 +105,34 @@ private:
 
     void run() override;
 
+protected:
+    bool initializeSolver() override;
+    void makeLogBasicInfo(std::ostream &log) override;
+    void makeLogStats(std::ostream &log) override;
+
 public:
     explicit LAPIBT(LargeAgentsMapfProblem *P);
     explicit LAPIBT(LargeAgentsMapfProblem *P, int iheritanceDepth);
+    ~LAPIBT() override;
+
+    // throws too_high_compute_time_exception once out of time, the paths and the timestep are
+    // then as before the call, so step() can be called again
+    Config step() override;
+    void updateGoal(int i, Node *g) override;
+    int getTimestep() const { return timestep; }
+    int getRestarts() const { return restart_timesteps.size(); }
 
-    Nodes getNodesToAvoidInheritanceConflict(const Agent *child_agent, const Agent *parent_agent);
+    const SolverStats &getStats() const { return stats; }
+
+    // appended to nodes
+    void getNodesToAvoidInheritanceConflict(const Agent *child_agent, const Agent *parent_agent, Nodes &nodes);
     
     bool collisionConflict(Agent *child_agent, Agent *parent_agent, const std::vector<Agent *> &allAgents);
     bool collisionConflict(Agent *child_agent, const std::vector<Agent *> &allAgents);
     
     bool inheritanceConflict(Agent *agent, const std::vector<Agent *> &allAgents);
 
-    std::map<Agent*, PathState> solveInheritanceConflict(Agent *child_agent, const std::vector<Agent *> &allAgents);
-    std::map<Agent*, PathState> escapeInheritanceConflict(Agent *child_agent, Agent *parent_agent, const std::vector<Agent *> &allAgents);
-    };
+    // true if solved, the paths changed are saved on saved_paths from its size at the call on
+    bool solveInheritanceConflict(Agent *child_agent, const std::vector<Agent *> &allAgents);
+    bool escapeInheritanceConflict(Agent *child_agent, Agent *parent_agent, const std::vector<Agent *> &allAgents);
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <deque>
+
+#include "mapf_solver.hpp"
+
+/*
+ * Lifelong MAPF for large agents.
+ * The goals of the instance are the first tasks. Afterwards, task_frequency tasks
+ * per timestep are released until task_num more tasks have been released.
+ * Tasks are random goals, or goals read from task_file (one x,y per line).
+ * Every agent that reaches its goal is given the oldest released task that fits
+ * its footprint, is reachable and does not overlap the goals of other agents;
+ * without such a task it waits on its goal.
+ * Reachability is decided by the connected components of the footprint, and by
+ * the prefetched distance table of the task once it is ready. Otherwise a task
+ * farther than max_timestep is known only once the table of the agent is ready, it
+ * is then put back and not offered to that agent again until it completes a task.
+ */
+class LifelongLargeAgentsMAPF
+{
+private:
+    LargeAgentsMapfProblem *const P;
+    LargeAgentsMAPFSolver *const solver;
+    const int task_num;          // tasks released after the initial goals
+    const float task_frequency;  // tasks released per timestep
+
+    Nodes task_file_goals;       // tasks from task_file, in order
+    AgentShapes task_shapes;     // largest shape of every kind, random tasks fit all of them
+    std::deque<Node *> open_tasks; // released, not yet assigned
+    int released_tasks;
+    std::vector<bool> has_task;  // agent is heading to a task goal
+    Config previous_goals;       // goal of each agent before its current task
+    std::vector<Nodes> dropped_tasks; // put back as beyond max_timestep, since the last completed task
+    std::vector<int> completion_timesteps; // timestep of every completed task
+    int timestep;
+
+    void readTaskFile(const std::string &task_file);
+    void releaseTasks();
+    Node *generateTask();
+    bool assignTask(int i, Node *g);
+
+    void halt(const std::string &msg) const;
+
+public:
+    LifelongLargeAgentsMAPF(LargeAgentsMapfProblem *P, LargeAgentsMAPFSolver *solver);
+
+    // step the solver until every task is completed, or max_timestep/max_comp_time is reached
+    void solve();
+
+    int getTasksCompleted() const { return completion_timesteps.size(); }
+    int getTasksReleased() const { return released_tasks; }
+    int getTimestep() const { return timestep; }
+    bool succeed() const;
+    double getThroughput() const; // completed tasks per timestep
+
+    void printResult() const;
+    void makeLog(const std::string &logfile);
+};
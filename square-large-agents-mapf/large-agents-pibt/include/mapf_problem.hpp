@@ -1,8 +1,11 @@
 #pragma once
+#include <memory>
 #include <random>
 
 #include "default_params.hpp"
 #include "graph_utils.hpp"
+#include "grid_csr.hpp"
+#include "grid_store.hpp"
 
 using Config = std::vector<Node *>; // < loc_0[t], loc_1[t], ... >
 using Configs = std::vector<Config>;
@@ -45,6 +48,7 @@ protected:
   int num_agents;       // number of agents
   int max_timestep;     // timestep limit
   int max_comp_time;    // comp_time limit, ms
+  bool halt_throws = false; // halt() throws invalid_instance_exception instead of exiting
 
   // utilities
   void halt(const std::string &msg) const;
@@ -52,13 +56,16 @@ protected:
 
 public:
   MapfProblem() {};
-  MapfProblem(const std::string &_instance) : instance(_instance) {}
+  MapfProblem(const std::string &_instance)
+      : instance(_instance), G(nullptr), MT(nullptr), num_agents(0),
+        max_timestep(0), max_comp_time(0) {}
   MapfProblem(std::string _instance, Graph *_G, std::mt19937 *_MT, Config _config_s,
               Config _config_g, int _num_agents, int _max_timestep,
               int _max_comp_time);
   ~MapfProblem() {};
 
   Graph *getG() { return G; }
+  Grid *getGrid() { return static_cast<Grid *>(G); } // instances are read from map files
   int getNum() { return num_agents; }
   std::mt19937 *getMT() { return MT; }
   Node *getStart(int i) const; // return start of a_i
@@ -70,13 +77,23 @@ public:
   std::string getInstanceFileName() { return instance; };
 
   void setMaxCompTime(const int t) { max_comp_time = t; }
+  void setGoal(int i, Node *g); // change goal of a_i
 };
 
 class LargeAgentsMapfProblem : public MapfProblem
 {
 private:
   const bool instance_initialized; // for memory manage
-  std::vector<float> sizes;     // To collect sizes of robots
+  GridStore *grid_store = nullptr; // owner of G if given
+  std::vector<float> sizes;     // To collect sizes of robots, the larger side of rectangles
+  AgentShapes shapes;           // of every agent, from sizes=, shape= and shapes=
+  ShapeKind shape = ShapeKind::SQUARE;  // of the instance, MIXED unless all agents have the same
+  std::shared_ptr<const GridCSR> csr;   // of G, shared with the problems derived from this one
+
+  // lifelong setting
+  int task_num = DEFAULT_TASK_NUM;                 // tasks released after the initial goals
+  float task_frequency = DEFAULT_TASK_FREQUENCY;   // tasks released per timestep
+  std::string task_file;                           // optional, one x,y goal per line
 
   // set starts and goals randomly
   void setRandomStartsGoals();
@@ -91,20 +108,36 @@ private:
 public:
   std::vector<float> getSizes() { return sizes; }
   float getSize(int i) { return sizes[i]; }
+  ShapeKind getShape() const { return shape; }
+  const AgentShapes &getAgentShapes() const { return shapes; }
+  const AgentShape &getAgentShape(int i) const { return shapes[i]; }
+  const GridCSR &getCSR() const { return *csr; }
   LargeAgentsMapfProblem(const std::string &_instance);
   LargeAgentsMapfProblem(const std::string& _instance, const int seed);
+  // the map is taken from grid_store instead of being loaded again
+  LargeAgentsMapfProblem(const std::string& _instance, GridStore *_grid_store);
 
   std::vector<float> getMinMaxRadiuses();
 
   LargeAgentsMapfProblem(LargeAgentsMapfProblem *P, Config _config_s, Config _config_g,
                        int _max_comp_time, int _max_timestep, std::vector<float> *_sizes);
   LargeAgentsMapfProblem(LargeAgentsMapfProblem *P, int _max_comp_time);
+  // problem given without instance file, G and MT are owned by the caller
+  LargeAgentsMapfProblem(const std::string &_instance, Graph *_G, std::mt19937 *_MT,
+                         Config _config_s, Config _config_g, AgentShapes _shapes,
+                         int _max_timestep, int _max_comp_time);
   ~LargeAgentsMapfProblem();
 
   bool isInitializedInstance() const { return instance_initialized; }
 
+  int getTaskNum() const { return task_num; }
+  float getTaskFrequency() const { return task_frequency; }
+  std::string getTaskFile() const { return task_file; }
+
   // used when making new instance file
   void makeScenFile(const std::string &output_file);
-  bool isInCollision(Config *C, int id, float r);
-  bool isInCollision(Config *C, int x, int y, float r);
+  // an agent of the shape fits on the map at (x, y)
+  bool fits(int x, int y, const AgentShape &s) const;
+  // ignored_agent is skipped, e.g., when the goal of that agent is being replaced
+  bool isInCollision(Config *C, int x, int y, const AgentShape &s, int ignored_agent = -1);
 };
\ No newline at end of file
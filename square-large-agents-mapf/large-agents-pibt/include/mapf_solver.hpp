@@ -3,10 +3,20 @@
 #include "paths.hpp"
 #include "utils.hpp"
 #include "plan.hpp"
+#include "trace.hpp"
+#include "thread_pool.hpp"
+#include "distance_table_cache.hpp"
+#include "reservation_table.hpp"
+#include "occupancy_raster.hpp"
+#include "grid_bfs.hpp"
+#include "distance_oracle.hpp"
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <memory>
 #include <queue>
+#include <deque>
+#include <unordered_set>
 #include <unordered_map>
 #include <iostream>
 
@@ -69,17 +79,15 @@ protected:
     // space-time A*
     struct AstarNode
     {
-        Node *v;          // location
-        int g;            // time
-        int f;            // f-value
-        AstarNode *p;     // parent
-        std::string name; // name
-        AstarNode(Node *_v, int _g, int _f, AstarNode *_p)
-            : v(_v), g(_g), f(_f), p(_p), name(getName(_v, _g)) {};
-
-        static std::string getName(Node *_v, int _g)
+        Node *v;      // location
+        int g;        // time
+        int f;        // f-value
+        AstarNode *p; // parent
+        uint64_t key; // (time, location), key of the closed set
+
+        static uint64_t getKey(Node *_v, int _g)
         {
-            return std::to_string(_v->id) + "-" + std::to_string(_g);
+            return (uint64_t(_g) << 32) | uint32_t(_v->id);
         };
     };
     using CompareAstarNode = std::function<bool(AstarNode *, AstarNode *)>;
@@ -87,6 +95,24 @@ protected:
     using CheckInvalidAstarNode = std::function<bool(AstarNode *)>;
     using AstarHeuristics = std::function<int(AstarNode *)>;
     using AstarNodes = std::vector<AstarNode *>;
+
+    // nodes of one search, the memory is kept for the next one
+    class AstarNodePool
+    {
+        std::deque<AstarNode> nodes; // never moved while growing
+        size_t used = 0;
+
+    public:
+        AstarNode *create(Node *v, int g, AstarNode *p)
+        {
+            if (used == nodes.size()) nodes.emplace_back();
+            AstarNode *n = &nodes[used++];
+            *n = {v, g, 0, p, AstarNode::getKey(v, g)};
+            return n;
+        }
+        void clear() { used = 0; }
+    };
+
     /*
      * Template of Space-Time A*.
      * See the following reference.
@@ -94,21 +120,29 @@ protected:
      * Cooperative Pathﬁnding.
      * D. Silver.
      * AI Game Programming Wisdom 3, pages 99–111, 2006.
+     *
+     * From time_horizon on nothing changes over time,
+     * a location reached later than before is not expanded again.
      */
-    //  static Path getPathBySpaceTimeAstar(
-    //      Node* const s,                 // start
-    //      Node* const g,                 // goal
-    //      AstarHeuristics& fValue,       // func: f-value
-    //      CompareAstarNode& compare,     // func: compare two nodes
-    //      CheckAstarFin& checkAstarFin,  // func: check goal
-    //      CheckInvalidAstarNode&
-    //          checkInvalidAstarNode,  // func: check invalid nodes
-    //      const int time_limit = -1   // time limit
-    //  );
-    //
+    Path getPathBySpaceTimeAstar(
+        Node *const s,                                // start
+        Node *const g,                                // goal
+        AstarHeuristics &fValue,                      // func: f-value
+        CompareAstarNode &compare,                    // func: compare two nodes
+        CheckAstarFin &checkAstarFin,                 // func: check goal
+        CheckInvalidAstarNode &checkInvalidAstarNode, // func: check invalid nodes
+        const int time_limit = -1,                    // time limit, ms
+        const int time_horizon = -1                   // disabled if -1
+    );
+
     // typical functions
     static CompareAstarNode compareAstarNodeBasic;
 
+private:
+    AstarNodePool astar_nodes;
+    AstarNodes astar_open;                   // binary heap
+    std::unordered_set<uint64_t> astar_closed;
+
 public:
     virtual void solve(); // call start -> run -> end
 protected:
@@ -129,6 +163,16 @@ public:
     int getSolverElapsedTime() const; // get elapsed time from start
 };
 
+// how a child of LAPIBT leaves the footprint of its parent
+enum class EscapeSearch
+{
+    GREEDY, // Euclidean walk towards the border nodes of the parent, one after another
+    BFS,    // breadth-first route to the nearest node clear of the agents in conflict
+};
+// "greedy" or "bfs", false if unknown
+bool parseEscapeSearch(const std::string &name, EscapeSearch &search);
+std::string getEscapeSearchName(EscapeSearch search);
+
 // -----------------------------------------------
 // base class for Large Agents
 // -----------------------------------------------
@@ -138,40 +182,168 @@ public:
     int getLowerBoundSOC();
     int getLowerBoundMakespan();
     void makeLog(const std::string &logfile = "./result.txt");
+    void makeLog(std::ostream &log);
+    void makeStats(const std::string &statsfile);
     void printResult();
+    int getPreprocessingCompTime() const { return preprocessing_comp_time; }
     int pathDist(int i, Node *s) const;
     int pathDist(int i) const;
+    // neighbours of a node, in a fixed array, grids have at most 4
+    struct Successors
+    {
+        Node *nodes[4];
+        int size = 0;
+        Node *const *begin() const { return nodes; }
+        Node *const *end() const { return nodes + size; }
+    };
+    // neighbours of v by pathDist(i, .), ties in the order of v->neighbor
+    Successors getSuccessors(int i, Node *v) const;
     void createDistanceTable();
+    void createDistanceTable(int i);
+    // of agents of one shape class at once, count <= GridBFS::MAX_BATCH
+    void createDistanceTables(const int *agents, int count);
     void checkIfComputationTimeExceeded();
+    void setTrace(TraceWriter *_trace) { trace = _trace; }
+    void setTimestepBudget(int _timestep_budget) { timestep_budget = _timestep_budget; }
+    void setStallWindow(int _stall_window) { stall_window = _stall_window; }
+    void setConflictBackend(ConflictBackend _backend) { conflict_backend = _backend; }
+    void setEscapeSearch(EscapeSearch _search) { escape_search = _search; }
+    void setDistanceOracle(DistanceOracle _oracle) { distance_oracle = _oracle; }
+    // improve a solved instance by large neighbourhood search for up to time_limit ms
+    void setLNS(int time_limit, int neighborhood_size);
+    int getLNSImprovements() const { return lns_improvements; }
+    // the solver stops as if out of time once *flag is set, e.g. by another thread
+    void setCancelFlag(const std::atomic<bool> *flag) { cancel_flag = flag; }
+    bool isCancelled() const { return cancel_flag != nullptr && cancel_flag->load(); }
+    // read-only use of the distance tables of a preprocessed solver of the same problem
+    void shareDistanceTable(LargeAgentsMAPFSolver *other);
     explicit LargeAgentsMAPFSolver(LargeAgentsMapfProblem *P);
     ~LargeAgentsMAPFSolver() override;
 
+    // incremental solving, instead of solve():
+    // initialize() once, then every step() returns the next configuration.
+    // Goals can be changed between steps, succeed() is true while all agents are on their goals.
+    bool initialize();
+    virtual Config step();
+    virtual void updateGoal(int i, Node *g);
+    void finalize() { end(); } // stop the clock, sets comp_time
+
+    // distance tables of updateGoal() are computed by num_threads background workers,
+    // pathDist() of such an agent is the Manhattan distance until its table is ready
+    void setDistanceTableWorkers(int num_threads);
+    // with workers, the tables of the first goals of the queue are computed ahead for every shape
+    // class and taken over by updateGoal(); those of goals that left the head are dropped
+    void prefetchDistanceTables(const std::deque<Node *> &goals);
+    bool isDistanceTableReady(int i) const { return pending_tables[i] == nullptr; }
+    // agent i can get from v to g, by the connected components of its footprint, no table is built;
+    // also within max_timestep if the prefetched table of g is ready
+    bool isReachable(int i, Node *v, Node *g);
+    // tables are taken from / added to the cache, which may be shared by several solvers
+    void setDistanceTableCache(DistanceTableCache *_cache) { distance_table_cache = _cache; }
+    // BFS from goal over the nodes where an agent of the footprint of bfs fits, thread-safe
+    static void computeDistanceTable(const GridBFS &bfs, Node *goal, int max_timestep,
+                                     std::vector<int> &table);
+
     // used for checking conflicts
     void updateSizedPathTable(const PathsWithRadius &paths, const int id);
     void clearSizedPathTable(const PathsWithRadius &paths);
     void updateSizedPathTableWithoutClear(const int id, const PathWithRadius &path,
                                           const PathsWithRadius &paths);
+    // true if agent id at v overlaps a reserved agent at t, or swaps with it on u -> v
+    bool sizedPathTableConflict(int id, Node *u, Node *v, int t) const;
+    bool sizedPathTableConflict(int id, Node *v, int t) const;
+    // shortest path avoiding the reservations, staying on the goal afterwards,
+    // empty if none of at most max_cost is found
+    PathWithRadius getSizedPathBySpaceTimeAstar(int id, int max_cost, int time_limit);
 
-    static PathsWithRadius planToSizedPaths(const Plan &plan);  // plan -> paths
+    PathsWithRadius planToSizedPaths(const Plan &plan) const;  // plan -> paths
     static Plan sizedPathsToPlan(const PathsWithRadius &paths); // paths -> plan
 
 protected:
     LargeAgentsMapfProblem *const P;
+    const GridCSR &csr; // of G, for loops over the map
     using DistanceTable = std::vector<std::vector<int>>;
     DistanceTable distance_table;
     DistanceTable *distance_table_p;
+    // agent -> node id -> getSuccessors() as 2-bit indices into neighbor, closest first,
+    // built with the distance table, empty while it is pending
+    using SuccessorOrder = std::vector<std::vector<uint8_t>>;
+    SuccessorOrder successor_order;
+    SuccessorOrder *successor_order_p = nullptr;
+    void createSuccessorOrder(int i);
     int preprocessing_comp_time;
+    TraceWriter *trace = nullptr; // timeline of solver phases, disabled if nullptr
+    int timestep_budget = 0;      // planning deadline of a single timestep, ms, disabled if 0
+    const std::atomic<bool> *cancel_flag = nullptr; // disabled if nullptr
+    int stall_window = 0;         // timesteps without progress before a restart, disabled if 0
+    ConflictBackend conflict_backend = ConflictBackend::PAIRWISE;
+    EscapeSearch escape_search = EscapeSearch::BFS;
+    DistanceOracle distance_oracle = DistanceOracle::EXACT;
     virtual void run() {}
-    virtual void makeLogBasicInfo(std::ofstream &log);
-    virtual void makeLogSolution(std::ofstream &log);
+    virtual bool initializeSolver() { return true; }
+    void preprocess();
+    void syncDistanceTables(); // take over the tables finished by the workers
+    virtual void makeLogBasicInfo(std::ostream &log);
+    virtual void makeLogSolution(std::ostream &log);
+    virtual void makeLogStats(std::ostream &log) {}
     static constexpr int NIL = -1;
-    std::vector<std::vector<int>> PATH_TABLE;
+    ReservationTable reservations; // footprints of the paths of updateSizedPathTable*()
+    bool fits(int i, Node *v) { return fits(i, v->id); }
+    bool fits(int i, int id);      // agent i fits at node id, by the clearance map of its shape class
 
 private:
     int LB_soc;
     int LB_makespan;
+
+    struct PendingDistanceTable
+    {
+        std::future<void> done;
+        std::shared_ptr<std::vector<int>> table; // shared with the worker
+    };
+    struct PrefetchedDistanceTables
+    {
+        Node *goal;
+        std::future<void> done;
+        std::vector<std::shared_ptr<std::vector<int>>> tables; // per shape class, shared with the worker
+    };
+    // clearance map per shape class (AgentShape::footprint), node id -> fits,
+    // filled on first use of a node, UNKNOWN before
+    enum Clearance : char { UNKNOWN, BLOCKED, CLEAR };
+    AgentShapes shape_classes;
+    std::vector<int> shape_class_of; // agent -> index in shape_classes
+    std::vector<std::vector<Clearance>> clearance_maps;
+
+    std::unique_ptr<ThreadPool> distance_table_workers;
+    std::vector<std::unique_ptr<PendingDistanceTable>> pending_tables; // nullptr if ready
+    int async_distance_tables = 0;
+    static constexpr int PREFETCHED_GOALS_PER_WORKER = 2;
+    std::vector<std::unique_ptr<PrefetchedDistanceTables>> prefetched_tables;
+    int prefetched_distance_tables = 0; // taken over by updateGoal()
+    DistanceTableCache *distance_table_cache = nullptr; // not owned, disabled if nullptr
+    void requestDistanceTable(int i);
+    // per shape class, built with the first table of the class
+    std::vector<std::shared_ptr<const GridBFS>> distance_bfs;
+    std::shared_ptr<const GridBFS> getDistanceBFS(int i);
+    // DistanceOracle::HIERARCHICAL, instead of distance_table, shared like distance_table_p
+    std::unique_ptr<HierarchicalDistanceOracle> hierarchical_oracle;
+    HierarchicalDistanceOracle *hierarchical_oracle_p = nullptr;
+    size_t getDistanceMemory() const; // bytes of what pathDist() looks up
+    static void lookupDistanceTable(DistanceTableCache *cache, const GridBFS &bfs, Grid *grid,
+                                    Node *goal, const AgentShape &shape, int max_timestep,
+                                    std::vector<int> &table);
     void exec() override;
     void computeLowerBounds();
+
+    // large neighbourhood search: replan a few agents at once, keep the plan if the SOC drops
+    int lns_time_limit = 0;    // ms, disabled if 0
+    int lns_neighborhood_size = 0;
+    static constexpr int LNS_ITERATION_SHARE = 10; // an iteration gets at most 1/10 of lns_time_limit
+    int lns_iterations = 0;
+    int lns_improvements = 0;
+    std::vector<std::pair<int, int>> lns_soc_over_time; // (elapsed ms, soc) of every improvement
+    void improveSolutionByLNS();
+    std::vector<int> selectNeighborhood(const PathsWithRadius &paths);
+    static int getSizedPathCost(const PathWithRadius &path); // first arrival, as Plan::getSOC()
 };
 
 std::unique_ptr<LargeAgentsMAPFSolver> getSolver(const std::string &solver_name,
@@ -0,0 +1,66 @@
+#pragma once
+#include <graph.hpp>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "shapes.hpp"
+
+// how LAPIBT finds agents colliding with a candidate move
+enum class ConflictBackend
+{
+    PAIRWISE, // Shape::overlap against the paths of all agents
+    RASTER,   // OccupancyRaster first, Shape::overlap only for the agents it does not rule out
+};
+
+// "pairwise" or "raster", false if unknown
+bool parseConflictBackend(const std::string &name, ConflictBackend &backend);
+std::string getConflictBackendName(ConflictBackend backend);
+
+/*
+ * Footprints of the paths of agents, one occupancy bitset over the grid per path offset.
+ *
+ * Layer k holds the cells covered by the k-th node of every path given to setPath(),
+ * a bit is set while at least one footprint covers its cell. A footprint is tested
+ * against a layer with word-wide ANDs of its rows.
+ *
+ * Footprints are rasterised conservatively: squares and rectangles cover their box of
+ * cells, circles every cell closer than radius + 0.75 to their centre. Any two agents
+ * that overlap by one of the policies of shapes.hpp share a cell, so no intersection
+ * means no collision; an intersection still has to be confirmed by Shape::overlap.
+ *
+ * setPath() costs O(footprint) per node that differs from the previous path of the agent.
+ */
+class OccupancyRaster
+{
+private:
+    const int width;
+    const int height;
+    const int words; // per row of a layer
+
+    struct Span
+    {
+        int dy, x0, x1; // cells [x0, x1] of row dy, relative to the anchor
+    };
+    std::vector<std::vector<Span>> spans; // per footprint, distinct
+    std::vector<int> class_of;            // agent -> index in spans
+
+    std::vector<std::vector<uint16_t>> counts; // layer -> cell -> number of footprints
+    std::vector<std::vector<uint64_t>> bits;   // layer -> row * words + word
+    std::vector<int> population;               // layer -> number of footprints
+    std::vector<std::vector<Node *>> paths;    // agent -> nodes in the layers
+
+    void update(int id, int layer, Node *v, int d);
+
+public:
+    OccupancyRaster(Grid *grid, const AgentShapes &shapes);
+
+    // agent id occupies the first len nodes of path, from layer 0 on, instead of its previous path
+    void setPath(int id, const std::deque<Node *> &path, size_t len);
+    void clear();
+
+    // the footprint of agent id at v shares a cell with a layer >= from
+    bool intersects(int id, Node *v, int from) const;
+    int getLayers() const { return counts.size(); }
+};
@@ -10,6 +10,10 @@ struct Plan
 private:
     Configs configs; // main
 
+    // moves and conflicts of validateWithoutGoals, Shape as in shapes.hpp
+    template <class Shape>
+    bool validateMoves(LargeAgentsMapfProblem *P) const;
+
 public:
     ~Plan() {}
 
@@ -61,6 +65,8 @@ public:
     bool validate(LargeAgentsMapfProblem *P) const;
     bool validate(const Config &starts, const Config &goals) const;
     bool validate(const Config &starts) const;
+    // starts, moves and conflicts only, e.g., for lifelong plans whose goals change
+    bool validateWithoutGoals(LargeAgentsMapfProblem *P) const;
 
     // when updating a single path,
     // the path should be longer than this value to avoid conflicts
@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "mapf_solver.hpp"
+
+/*
+ * Portfolio of solvers of the same problem, run concurrently.
+ * Members differ in their random seed and inheritanceDepth, and share the map and
+ * the distance tables, which are computed once before the members start. Either the first valid plan
+ * wins and the other members are cancelled, or all members run until solved or
+ * out of time and the valid plan with the smallest SOC wins.
+ * Every solver, also the one computing the distance tables, is set up by the same
+ * configure function, e.g. with the options of the command line.
+ */
+class LargeAgentsMAPFPortfolio
+{
+public:
+    struct Member
+    {
+        int seed;
+        int inheritanceDepth;
+        bool solved = false;
+        bool valid = false;
+        int soc = 0;
+        int comp_time = 0;
+    };
+
+private:
+    LargeAgentsMapfProblem *const P;
+    const std::string solver_name;
+    const bool best_soc; // false, the first valid plan wins
+    const std::function<void(LargeAgentsMAPFSolver *)> configure;
+    std::vector<Member> members;
+    std::vector<std::unique_ptr<std::mt19937>> MTs;
+    std::vector<std::unique_ptr<LargeAgentsMapfProblem>> problems;
+    std::unique_ptr<LargeAgentsMAPFSolver> preprocessing_solver; // owner of the distance tables
+    std::vector<std::unique_ptr<LargeAgentsMAPFSolver>> solvers;
+    std::atomic<bool> cancelled;
+    int winner;           // -1 if no member found a valid plan
+    int preprocessing_comp_time;
+    int comp_time;
+
+public:
+    // member k uses seed + k and the k-th of inheritanceDepth, inheritanceDepth/2, 2*inheritanceDepth, ...
+    LargeAgentsMAPFPortfolio(LargeAgentsMapfProblem *P, const std::string &solver_name,
+                             int num_members, int seed, int inheritanceDepth, bool best_soc,
+                             std::function<void(LargeAgentsMAPFSolver *)> configure);
+
+    void solve();
+    bool succeed() const { return winner != -1; }
+    LargeAgentsMAPFSolver *getWinner() const; // nullptr if no member succeeded
+    const std::vector<Member> &getMembers() const { return members; }
+
+    void printResult() const;
+    void makeLog(const std::string &logfile);
+    void makeStats(const std::string &statsfile); // of the winner, otherwise of the first member
+};
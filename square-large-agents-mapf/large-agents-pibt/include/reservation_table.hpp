@@ -0,0 +1,63 @@
+#pragma once
+#include <graph.hpp>
+#include <unordered_map>
+#include <vector>
+
+#include "paths.hpp"
+#include "shapes.hpp"
+
+/*
+ * Sparse space-time reservation of the footprints of agents.
+ *
+ * Two agents collide iff Shape::overlap of the policy of the instance, the same test as
+ * Plan::validate. For every footprint (shape class) of the agents given to the constructor,
+ * a reservation
+ * marks the anchors where such a footprint would collide with it, so a query is a
+ * single lookup. A reserved path stays on its last node forever ("parked").
+ *
+ * Entries exist only where agents are, reserve/release cost O(footprint) per timestep.
+ * The queried agent itself must not be reserved.
+ */
+class ReservationTable
+{
+private:
+    const int width;
+    const int height;
+    const ShapeKind shape;         // of the instance, selects the policy
+    const AgentShapes shapes;      // of the agents
+    AgentShapes footprints;        // of the agents, distinct
+    std::vector<int> class_of;     // agent -> index in footprints
+
+    // per footprint, (t, anchor) -> number of reservations it collides with
+    std::vector<std::unordered_map<uint64_t, int>> blocked;
+    // per footprint, anchor -> arrival of every parked reservation it collides with
+    std::vector<std::unordered_map<int, std::vector<int>>> parked;
+    std::unordered_map<uint64_t, int> anchors;  // (t, node) -> agent, before its arrival
+    struct Parking
+    {
+        int agent;
+        int from;
+    };
+    std::unordered_map<int, Parking> parked_anchors;  // node -> agent on it from its arrival
+    int horizon = 0;  // last arrival, afterwards nothing changes over time
+
+    static uint64_t getKey(int t, int cell) { return (uint64_t(t) << 32) | uint32_t(cell); }
+    static int getArrival(const PathWithRadius &path); // the last node is not left from here
+    void update(int id, const PathWithRadius &path, int d);
+    template <class Shape>
+    void update(int id, const PathWithRadius &path, int d);
+
+public:
+    ReservationTable(Grid *grid, const AgentShapes &_shapes, ShapeKind _shape);
+
+    void reserve(int id, const PathWithRadius &path);
+    void release(int id, const PathWithRadius &path); // the path given to reserve()
+    void clear();
+
+    // true if agent id at v collides with no reservation at t
+    bool isFree(Node *v, int id, int t) const;
+    // agent whose anchor is v at t, -1 if none
+    int getOccupant(Node *v, int t) const;
+    int getHorizon() const { return horizon; }
+    size_t size() const; // number of entries
+};
@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "distance_table_cache.hpp"
+#include "grid_store.hpp"
+#include "mapf_solver.hpp"
+
+/*
+ * Long-running solver listening on a Unix domain socket.
+ * Maps are loaded once and distance tables are cached across requests,
+ * each connection is served by its own thread.
+ *
+ * A request is a list of key=value lines in the format of instance files
+ * (map_file, sizes, seed, max_timestep, max_comp_time, solver, inheritanceDepth,
+ * log_short and x_s,y_s,x_g,y_g lines), terminated by a line "end". The solver
+ * options timestep_budget, stall_window, conflict_backend, escape_search,
+ * distance_oracle, lns_time_limit and distance_table_workers default to configure.
+ * The response is the result log of the solve followed by "valid=" and "end",
+ * or "error=<reason>" and "end". A connection may send several requests,
+ * a request "shutdown" stops the server: running solves are cancelled and open
+ * connections are closed.
+ */
+class LargeAgentsMAPFServer
+{
+private:
+    const std::string socket_path;
+    DistanceTableCache cache;
+    GridStore maps;
+    std::atomic<bool> stopping;
+    int listen_fd;
+    std::mutex clients_mutex;
+    std::unordered_set<int> clients; // sockets of the open connections
+    std::condition_variable clients_closed;
+    const std::function<void(LargeAgentsMAPFSolver *)> configure; // before the options of a request
+
+    void serve(int fd);                        // requests of one connection, closes fd
+    void closeClient(int fd);
+    std::string solve(const std::vector<std::string> &request);
+
+public:
+    LargeAgentsMAPFServer(const std::string &socket_path, size_t cache_bytes,
+                          std::function<void(LargeAgentsMAPFSolver *)> configure);
+    ~LargeAgentsMAPFServer();
+
+    // accept connections until a shutdown request, false if the socket cannot be opened
+    bool run();
+    const DistanceTableCache &getCache() const { return cache; }
+};
@@ -0,0 +1,279 @@
+#pragma once
+#include <graph.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+/*
+ * Shapes of agents.
+ *
+ * Every agent has its own AgentShape:
+ *   SQUARE: border w (= h), anchored at its lower-left cell, covering [x, x + ceil(w))^2.
+ *   CIRCLE: radius w (= h) around its cell.
+ *   RECT:   axis-aligned w x h, anchored as a square, covering [x, x + ceil(w)) x [y, y + ceil(h)).
+ *
+ * A policy decides when two agents overlap, where an agent fits and where a child goes to
+ * escape its parent. Solvers and checks take it as a template parameter, so the tests are
+ * inlined into their loops; ShapeKind of the instance selects the instantiation once:
+ * SquareShape and CircleShape when all agents are squares or circles, MixedShape otherwise,
+ * which looks up the overlap of a pair of kinds in a constant table of kernels.
+ */
+enum class ShapeKind { SQUARE, CIRCLE, RECT, MIXED }; // MIXED only for instances
+
+struct AgentShape
+{
+    ShapeKind kind = ShapeKind::SQUARE;
+    float w = 0;
+    float h = 0;
+
+    static AgentShape make(ShapeKind kind, float size) { return {kind, size, size}; }
+    float getSize() const { return std::max(w, h); }
+    // shapes with the same footprint behave the same, used as the key of tables
+    AgentShape footprint() const
+    {
+        if (kind == ShapeKind::CIRCLE) return *this;
+        return {kind, std::ceil(w), std::ceil(h)};
+    }
+    bool operator==(const AgentShape &other) const
+    {
+        return kind == other.kind && w == other.w && h == other.h;
+    }
+};
+using AgentShapes = std::vector<AgentShape>;
+
+// cells covered relative to the anchor, a superset for circles
+struct ShapeExtent
+{
+    int x0, x1, y0, y1;
+};
+
+inline ShapeExtent getExtent(const AgentShape &s)
+{
+    if (s.kind == ShapeKind::CIRCLE) {
+        const int r = std::ceil(s.w);
+        return {-r, r, -r, r};
+    }
+    return {0, std::max(1, int(std::ceil(s.w))) - 1, 0, std::max(1, int(std::ceil(s.h))) - 1};
+}
+
+// kernels, squares and rectangles are boxes of cells, circles keep half a cell to a box
+inline bool overlapBoxes(const Pos &a, const AgentShape &s_a, const Pos &b, const AgentShape &s_b)
+{
+    return a.x > b.x - std::ceil(s_a.w) && a.x < b.x + std::ceil(s_b.w) &&
+           a.y > b.y - std::ceil(s_a.h) && a.y < b.y + std::ceil(s_b.h);
+}
+
+inline bool overlapCircles(const Pos &a, const AgentShape &s_a, const Pos &b, const AgentShape &s_b)
+{
+    const float dx = a.x - b.x;
+    const float dy = a.y - b.y;
+    const float r = s_a.w + s_b.w;
+    return dx * dx + dy * dy < r * r;
+}
+
+inline bool overlapCircleBox(const Pos &a, const AgentShape &s_a, const Pos &b, const AgentShape &s_b)
+{
+    // to the nearest cell of the box
+    const float dx = a.x - std::clamp(a.x, b.x, b.x + std::max(1, int(std::ceil(s_b.w))) - 1);
+    const float dy = a.y - std::clamp(a.y, b.y, b.y + std::max(1, int(std::ceil(s_b.h))) - 1);
+    const float r = s_a.w + 0.5f;
+    return dx * dx + dy * dy < r * r;
+}
+
+inline bool overlapBoxCircle(const Pos &a, const AgentShape &s_a, const Pos &b, const AgentShape &s_b)
+{
+    return overlapCircleBox(b, s_b, a, s_a);
+}
+
+// all cells along the border of the box at (x, y) are free
+inline bool fitsBox(Graph *G, int x, int y, const AgentShape &s)
+{
+    const int w = std::ceil(s.w);
+    const int h = std::ceil(s.h);
+    for (int dx = 0; dx <= w; ++dx)
+        if (!G->existNode(x + dx, y) || !G->existNode(x + dx, y + h)) return false;
+    for (int dy = 0; dy <= h; ++dy)
+        if (!G->existNode(x, y + dy) || !G->existNode(x + w, y + dy)) return false;
+    return true;
+}
+
+// its cell and all cells along the rasterised circle at (x, y) are free
+inline bool fitsCircle(Graph *G, int x, int y, const AgentShape &s)
+{
+    int dx = s.w;
+    int dy = 0;
+    if (!G->existNode(x, y)) return false;
+    if (dx == 0) return true;
+    do {
+        if (!G->existNode(x + dx, y + dy) || !G->existNode(x - dy, y + dx) ||
+            !G->existNode(x - dx, y - dy) || !G->existNode(x + dy, y - dx))
+            return false;
+        if (dx * dx + (dy + 1) * (dy + 1) <= s.w * s.w)
+            ++dy;
+        else
+            --dx;
+    } while (dx != 0);
+    return true;
+}
+
+inline bool fitsShape(Graph *G, int x, int y, const AgentShape &s)
+{
+    return s.kind == ShapeKind::CIRCLE ? fitsCircle(G, x, y, s) : fitsBox(G, x, y, s);
+}
+
+// how a child walks greedily to a location that avoids the inheritance conflict:
+//   ESCAPE_SKIP_PROBABILITY  a location is skipped at random with it, to prevent deadlocks
+//   ESCAPE_ANY_NEIGHBOUR     a blocked step tries the next neighbour instead of giving up
+//   escapeStepLimit()        steps of an escape, of both the greedy walk and the route
+struct SquareShape
+{
+    static constexpr ShapeKind KIND = ShapeKind::SQUARE;
+    static constexpr float ESCAPE_SKIP_PROBABILITY = 0.175f;
+    static constexpr bool ESCAPE_ANY_NEIGHBOUR = true;
+
+    static int escapeStepLimit(float child_size, float parent_size)
+    {
+        return 3 * std::ceil(std::max(child_size, parent_size));
+    }
+
+    static bool overlap(const Pos &a, const AgentShape &s_a, const Pos &b, const AgentShape &s_b)
+    {
+        return overlapBoxes(a, s_a, b, s_b);
+    }
+
+    static bool fits(Graph *G, int x, int y, const AgentShape &s) { return fitsBox(G, x, y, s); }
+
+    // locations of a child next to the parent, just outside of it, appended to nodes
+    static void border(Graph *G, const Node *parent, const AgentShape &s_parent,
+                       const AgentShape &s_child, Nodes &nodes)
+    {
+        const int x = parent->pos.x;
+        const int y = parent->pos.y;
+        const int s_p = std::ceil(s_parent.w);
+        const int s_c = std::ceil(s_child.w);
+        const int increment = std::max(1, (s_p + s_c) / 4);
+        for (int delta = 0; delta < s_p + s_c; delta += increment) {
+            if (G->existNode(x + delta, y - s_c)) nodes.push_back(G->getNode(x + delta, y - s_c));
+            if (G->existNode(x + delta, y + s_p)) nodes.push_back(G->getNode(x + delta, y + s_p));
+            if (G->existNode(x - s_c, y + delta)) nodes.push_back(G->getNode(x - s_c, y + delta));
+            if (G->existNode(x + s_p, y + delta)) nodes.push_back(G->getNode(x + s_p, y + delta));
+        }
+    }
+};
+
+// as the circle solver before the shapes were merged
+struct CircleShape
+{
+    static constexpr ShapeKind KIND = ShapeKind::CIRCLE;
+    static constexpr float ESCAPE_SKIP_PROBABILITY = 0.5f;
+    static constexpr bool ESCAPE_ANY_NEIGHBOUR = false;
+
+    static int escapeStepLimit(float, float) { return std::numeric_limits<int>::max(); }
+
+    static bool overlap(const Pos &a, const AgentShape &s_a, const Pos &b, const AgentShape &s_b)
+    {
+        return overlapCircles(a, s_a, b, s_b);
+    }
+
+    static bool fits(Graph *G, int x, int y, const AgentShape &s) { return fitsCircle(G, x, y, s); }
+
+    static void border(Graph *G, const Node *parent, const AgentShape &s_parent,
+                       const AgentShape &s_child, Nodes &nodes)
+    {
+        // midpoint ring of radius r_parent + r_child around the parent
+        const int x = parent->pos.x;
+        const int y = parent->pos.y;
+        const double r = s_child.w + s_parent.w;
+        int dx = std::ceil(r);
+        int dy = 0;
+        do {
+            if (G->existNode(x + dx, y + dy)) nodes.push_back(G->getNode(x + dx, y + dy));
+            if (G->existNode(x - dy, y + dx)) nodes.push_back(G->getNode(x - dy, y + dx));
+            if (G->existNode(x - dx, y - dy)) nodes.push_back(G->getNode(x - dx, y - dy));
+            if (G->existNode(x + dy, y - dx)) nodes.push_back(G->getNode(x + dy, y - dx));
+            if ((dx - 1) * (dx - 1) + dy * dy > r * r)
+                --dx;
+            else
+                ++dy;
+        } while (dx != 0);
+    }
+};
+
+// escapes as squares
+struct MixedShape
+{
+    static constexpr ShapeKind KIND = ShapeKind::MIXED;
+    static constexpr float ESCAPE_SKIP_PROBABILITY = SquareShape::ESCAPE_SKIP_PROBABILITY;
+    static constexpr bool ESCAPE_ANY_NEIGHBOUR = SquareShape::ESCAPE_ANY_NEIGHBOUR;
+
+    static int escapeStepLimit(float child_size, float parent_size)
+    {
+        return SquareShape::escapeStepLimit(child_size, parent_size);
+    }
+
+    using OverlapKernel = bool (*)(const Pos &, const AgentShape &, const Pos &, const AgentShape &);
+    // [kind of a][kind of b], SQUARE, CIRCLE, RECT
+    static constexpr OverlapKernel OVERLAP[3][3] = {
+        {overlapBoxes, overlapBoxCircle, overlapBoxes},
+        {overlapCircleBox, overlapCircles, overlapCircleBox},
+        {overlapBoxes, overlapBoxCircle, overlapBoxes},
+    };
+
+    static bool overlap(const Pos &a, const AgentShape &s_a, const Pos &b, const AgentShape &s_b)
+    {
+        return OVERLAP[int(s_a.kind)][int(s_b.kind)](a, s_a, b, s_b);
+    }
+
+    static bool fits(Graph *G, int x, int y, const AgentShape &s) { return fitsShape(G, x, y, s); }
+
+    // ring of anchors where the extent of the child is just outside of the parent's
+    static void border(Graph *G, const Node *parent, const AgentShape &s_parent,
+                       const AgentShape &s_child, Nodes &nodes)
+    {
+        const ShapeExtent p = getExtent(s_parent);
+        const ShapeExtent c = getExtent(s_child);
+        const int x0 = parent->pos.x + p.x0 - c.x1 - 1;
+        const int x1 = parent->pos.x + p.x1 - c.x0 + 1;
+        const int y0 = parent->pos.y + p.y0 - c.y1 - 1;
+        const int y1 = parent->pos.y + p.y1 - c.y0 + 1;
+        const int increment = std::max(1, (x1 - x0 + y1 - y0) / 8);
+        auto add = [&](int x, int y) {
+            if (G->existNode(x, y)) nodes.push_back(G->getNode(x, y));
+        };
+        for (int x = x0; x <= x1; x += increment) {
+            add(x, y0);
+            add(x, y1);
+        }
+        for (int y = y0 + increment; y < y1; y += increment) {
+            add(x0, y);
+            add(x1, y);
+        }
+    }
+};
+
+// calls f(SquareShape()), f(CircleShape()) or f(MixedShape()), once per kind-dependent operation
+template <class F>
+decltype(auto) withShape(ShapeKind kind, F &&f)
+{
+    if (kind == ShapeKind::SQUARE) return f(SquareShape());
+    if (kind == ShapeKind::CIRCLE) return f(CircleShape());
+    return f(MixedShape());
+}
+
+// kind of an instance, MIXED unless all agents have the same kind
+ShapeKind getShapeKind(const AgentShapes &shapes);
+
+// "square", "circle" or "rect", false if unknown
+bool parseShape(const std::string &name, ShapeKind &kind);
+std::string getShapeName(ShapeKind kind);
+// "w" or "wxh" for rectangles, as in sizes= of instances
+std::string getSizeName(const AgentShape &shape);
+// inverse of getSizeName, h is -1 if not given, throws std::logic_error if not a number
+void parseSize(const std::string &name, float &w, float &h);
+// shape i has kinds[i], if given, otherwise RECT if heights[i] != -1, otherwise default_kind;
+// false if a height is given for another kind
+bool makeAgentShapes(const std::vector<float> &widths, const std::vector<float> &heights,
+                     ShapeKind default_kind, const std::vector<ShapeKind> &kinds,
+                     AgentShapes &shapes);
@@ -0,0 +1,44 @@
+#pragma once
+#include <fstream>
+#include <vector>
+
+#include "utils.hpp"
+
+/*
+ * Hot-path counters of LAPIBT.
+ * Everything wrapped in LAPIBT_STAT(...) is compiled out
+ * unless the library is built with -DLAPIBT_STATS (cmake option LAPIBT_STATS).
+ * Timestep times are recorded in any case, they cost two clock reads per timestep.
+ */
+#ifdef LAPIBT_STATS
+#define LAPIBT_STAT(...) __VA_ARGS__
+#else
+#define LAPIBT_STAT(...)
+#endif
+
+struct SolverStats
+{
+    long long collision_conflict_calls = 0;              // collisionConflict(agent, allAgents)
+    long long raster_confirmations = 0;                  // collisionConflict calls the raster did not rule out
+    long long collision_conflict_in_inheritance_calls = 0; // collisionConflict(child, parent, allAgents)
+    long long inheritance_conflict_calls = 0;            // inheritanceConflict
+    long long solve_inheritance_conflict_calls = 0;      // solveInheritanceConflict
+    long long escape_attempts = 0;                       // escapeInheritanceConflict
+    long long escape_depth_limit_hits = 0;               // escapes refused by inheritanceDepth
+    long long escape_targets_tried = 0;                  // border nodes the greedy walk started towards, routes of BFS
+    long long escape_random_skips = 0;                   // border nodes skipped to prevent deadlocks
+    long long rollbacks = 0;                             // paths restored to a state before conflict
+    long long timestep_budget_fallbacks = 0;             // escapes refused because the timestep budget ran out
+    std::vector<long long> inheritance_depth_histogram;  // depth -> number of solveInheritanceConflict calls
+    std::vector<long long> timestep_times;               // planning time of each timestep, us
+
+    void recordInheritanceDepth(int depth);
+    void recordTimestepTime(const Time::time_point &t_start);
+
+    long long getTotalTimestepTime() const;
+    long long getTimestepTimePercentile(double percentile) const;
+
+    // key=value lines, in the format of the result file
+    void write(std::ostream &log) const;
+    void writeTimestepTimes(std::ostream &log, bool with_timesteps = false) const;
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed set of worker threads running submitted jobs in FIFO order.
+ * The destructor finishes every queued job before joining the workers.
+ */
+class ThreadPool
+{
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::packaged_task<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+
+    void work();
+
+public:
+    explicit ThreadPool(int num_threads); // num_threads <= 0, number of hardware threads
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    std::future<void> submit(std::function<void()> job);
+    int size() const { return workers.size(); }
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "default_params.hpp"
+#include "utils.hpp"
+
+/*
+ * Timeline of solver phases in Chrome trace-event format,
+ * open the file in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Events go to a bounded ring, when it is full the oldest events are overwritten,
+ * so a long run keeps its last `capacity` spans. Names must be string literals.
+ */
+class TraceWriter
+{
+public:
+    struct Event
+    {
+        const char *name;     // span name
+        const char *category; // solver phase
+        const char *arg_name; // name of the single argument, nullptr if none
+        int arg;              // e.g. agent id or timestep
+        long long ts;         // start, us since the writer was created
+        long long dur;        // duration, us
+    };
+
+private:
+    const size_t capacity; // bound of ring, which grows up to it as events come in
+    std::vector<Event> ring;
+    size_t next;          // index of the next event to write
+    size_t dropped;       // number of overwritten events
+    Time::time_point t_origin;
+
+public:
+    explicit TraceWriter(size_t capacity = DEFAULT_TRACE_CAPACITY);
+
+    long long now() const; // us since the writer was created
+    void add(const char *name, const char *category, long long ts,
+             const char *arg_name = nullptr, int arg = 0);
+
+    size_t size() const;
+    size_t getDropped() const { return dropped; }
+    void write(const std::string &tracefile) const;
+};
+
+// records a span from construction to destruction, does nothing if trace is nullptr
+class TraceSpan
+{
+private:
+    TraceWriter *const trace;
+    const char *const name;
+    const char *const category;
+    const char *const arg_name;
+    const int arg;
+    const long long ts;
+
+public:
+    TraceSpan(TraceWriter *trace, const char *name, const char *category,
+              const char *arg_name = nullptr, int arg = 0)
+        : trace(trace), name(name), category(category), arg_name(arg_name), arg(arg),
+          ts(trace != nullptr ? trace->now() : 0) {}
+    ~TraceSpan()
+    {
+        if (trace != nullptr)
+            trace->add(name, category, ts, arg_name, arg);
+    }
+};
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include "../include/batch.hpp"
+#include "../include/exceptions.hpp"
+
+namespace fs = std::filesystem;
+
+LargeAgentsMAPFBatch::LargeAgentsMAPFBatch(const std::string &_solver_name,
+                                           int _inheritanceDepth, int _max_comp_time,
+                                           std::function<void(LargeAgentsMAPFSolver *)> _configure,
+                                           size_t cache_bytes,
+                                           int num_threads)
+    : solver_name(_solver_name),
+      inheritanceDepth(_inheritanceDepth),
+      max_comp_time(_max_comp_time),
+      configure(std::move(_configure)),
+      cache(cache_bytes),
+      workers(num_threads) {}
+
+std::vector<std::string> LargeAgentsMAPFBatch::listInstances(const std::string &manifest_or_dir)
+{
+    std::vector<std::string> instances;
+    if (fs::is_directory(manifest_or_dir)) {
+        for (const auto &entry : fs::recursive_directory_iterator(manifest_or_dir)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".txt")
+                instances.push_back(entry.path().string());
+        }
+        std::sort(instances.begin(), instances.end());
+        return instances;
+    }
+
+    // manifest, one instance file per line, relative to the manifest
+    std::ifstream file(manifest_or_dir);
+    const fs::path base = fs::path(manifest_or_dir).parent_path();
+    std::string line;
+    while (getline(file, line)) {
+        if (!line.empty() && line.back() == 0x0d) line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        fs::path instance(line);
+        instances.push_back((instance.is_absolute() ? instance : base / instance).string());
+    }
+    return instances;
+}
+
+std::vector<LargeAgentsMAPFBatch::Result> LargeAgentsMAPFBatch::run(
+    const std::vector<std::string> &instances, const std::string &output_dir)
+{
+    fs::create_directories(output_dir);
+
+    std::vector<Result> results(instances.size());
+    std::vector<std::future<void>> done;
+    for (size_t k = 0; k < instances.size(); ++k) {
+        // e.g. maze_128_128_10/0_1-3/50.txt -> maze_128_128_10_0_1-3_50.txt
+        std::string name = fs::path(instances[k]).lexically_normal().string();
+        std::replace(name.begin(), name.end(), '/', '_');
+        name.erase(0, name.find_first_not_of("._"));
+        const std::string output_file = (fs::path(output_dir) / name).string();
+        done.push_back(workers.submit(
+            [this, &results, &instances, k, output_file] {
+                results[k] = solve(instances[k], output_file);
+            }));
+    }
+    for (auto &d : done) d.wait();
+    return results;
+}
+
+LargeAgentsMAPFBatch::Result LargeAgentsMAPFBatch::solve(const std::string &instance_file,
+                                                         const std::string &output_file)
+{
+    Result result;
+    result.instance = instance_file;
+    if (!std::ifstream(instance_file)) {
+        std::cout << "warn@Batch: file " << instance_file << " is not found" << std::endl;
+        return result;
+    }
+
+    std::unique_ptr<LargeAgentsMapfProblem> problem;
+    try {
+        problem = std::make_unique<LargeAgentsMapfProblem>(instance_file, &maps);
+    } catch (invalid_instance_exception &e) {
+        std::cout << "warn@Batch: " << instance_file << ", " << e.message() << std::endl;
+        return result;
+    } catch (std::logic_error &e) {
+        std::cout << "warn@Batch: " << instance_file << ", invalid number" << std::endl;
+        return result;
+    }
+    LargeAgentsMapfProblem &P = *problem;
+    if (max_comp_time != -1) P.setMaxCompTime(max_comp_time);
+
+    auto solver = getSolver(solver_name, &P, inheritanceDepth, false, 0, nullptr);
+    configure(solver.get());
+    solver->setDistanceTableCache(&cache);
+    solver->solve();
+
+    result.solved = solver->succeed();
+    result.valid = result.solved && solver->getSolution().validate(&P);
+    result.soc = solver->getSolution().getSOC();
+    result.makespan = solver->getSolution().getMakespan();
+    result.comp_time = solver->getCompTime();
+    result.preprocessing_comp_time = solver->getPreprocessingCompTime();
+    solver->makeLog(output_file);
+    return result;
+}
+
+void LargeAgentsMAPFBatch::writeSummary(const std::vector<Result> &results,
+                                        const std::string &summary_file) const
+{
+    std::ofstream log(summary_file);
+    log << "instance,solved,valid,soc,makespan,comp_time,preprocessing_comp_time\n";
+    for (const auto &r : results) {
+        log << r.instance << "," << r.solved << "," << r.valid << "," << r.soc << ","
+            << r.makespan << "," << r.comp_time << "," << r.preprocessing_comp_time << "\n";
+    }
+}
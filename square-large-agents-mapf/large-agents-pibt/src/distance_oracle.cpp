@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+#include "../include/distance_oracle.hpp"
+
+static const char *DISTANCE_ORACLE_NAMES[] = {"exact", "hierarchical"};
+
+bool parseDistanceOracle(const std::string &name, DistanceOracle &oracle)
+{
+    for (auto o : {DistanceOracle::EXACT, DistanceOracle::HIERARCHICAL}) {
+        if (name != DISTANCE_ORACLE_NAMES[int(o)]) continue;
+        oracle = o;
+        return true;
+    }
+    return false;
+}
+
+std::string getDistanceOracleName(DistanceOracle oracle)
+{
+    return DISTANCE_ORACLE_NAMES[int(oracle)];
+}
+
+size_t HierarchicalDistanceOracle::Abstraction::getMemory() const
+{
+    size_t bytes = portal_node.size() * sizeof(int) + local.size() * sizeof(uint16_t);
+    for (auto &c : clusters) bytes += sizeof(Cluster) + c.portals.size() * sizeof(int);
+    for (auto &e : edges) bytes += sizeof(e) + e.size() * sizeof(Edge);
+    return bytes;
+}
+
+HierarchicalDistanceOracle::HierarchicalDistanceOracle(Grid *_grid, const GridCSR &_csr,
+                                                       int agents, int shape_classes,
+                                                       int _unreachable)
+    : csr(_csr), width(_grid->getWidth()), height(_grid->getHeight()),
+      columns((width + CLUSTER - 1) / CLUSTER), rows((height + CLUSTER - 1) / CLUSTER),
+      unreachable(_unreachable), abstractions(shape_classes), goals(agents)
+{
+}
+
+std::unique_ptr<HierarchicalDistanceOracle::Abstraction>
+HierarchicalDistanceOracle::buildAbstraction(const GridBFS &bfs) const
+{
+    auto a = std::make_unique<Abstraction>();
+    a->clusters.resize(columns * rows);
+
+    std::unordered_map<int, int> portal_of; // node id -> portal
+    auto getPortal = [&](int x, int y) {
+        const int id = y * width + x;
+        auto itr = portal_of.find(id);
+        if (itr != portal_of.end()) return itr->second;
+        const int p = a->portal_node.size();
+        portal_of[id] = p;
+        a->portal_node.push_back(id);
+        a->edges.emplace_back();
+        a->clusters[(y >> CLUSTER_SHIFT) * columns + (x >> CLUSTER_SHIFT)].portals.push_back(p);
+        return p;
+    };
+    auto connect = [&](int ax, int ay, int bx, int by) {
+        const int p = getPortal(ax, ay);
+        const int q = getPortal(bx, by);
+        a->edges[p].push_back({q, 1});
+        a->edges[q].push_back({p, 1});
+    };
+
+    // runs of open cells on both sides of a border, cut where the clusters along it change
+    for (int x = CLUSTER - 1; x + 1 < width; x += CLUSTER) {
+        int start = -1;
+        for (int y = 0; y <= height; ++y) {
+            const bool open = y < height && bfs.isOpen(x, y) && bfs.isOpen(x + 1, y);
+            if (start >= 0 && (!open || (y & (CLUSTER - 1)) == 0)) {
+                connect(x, (start + y - 1) / 2, x + 1, (start + y - 1) / 2);
+                start = -1;
+            }
+            if (open && start < 0) start = y;
+        }
+    }
+    for (int y = CLUSTER - 1; y + 1 < height; y += CLUSTER) {
+        int start = -1;
+        for (int x = 0; x <= width; ++x) {
+            const bool open = x < width && bfs.isOpen(x, y) && bfs.isOpen(x, y + 1);
+            if (start >= 0 && (!open || (x & (CLUSTER - 1)) == 0)) {
+                connect((start + x - 1) / 2, y, (start + x - 1) / 2, y + 1);
+                start = -1;
+            }
+            if (open && start < 0) start = x;
+        }
+    }
+
+    // BFS inside of every cluster from each of its portals
+    const int offsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    std::vector<int> queue;
+    for (int c = 0; c < columns * rows; ++c) {
+        auto &cluster = a->clusters[c];
+        cluster.first = a->local.size();
+        a->local.resize(cluster.first + cluster.portals.size() * CLUSTER * CLUSTER, FAR);
+        const int cx = (c % columns) * CLUSTER;
+        const int cy = (c / columns) * CLUSTER;
+        const int cw = std::min(CLUSTER, width - cx);
+        const int ch = std::min(CLUSTER, height - cy);
+        for (size_t k = 0; k < cluster.portals.size(); ++k) {
+            uint16_t *local = &a->local[cluster.first + k * CLUSTER * CLUSTER];
+            const int s = a->portal_node[cluster.portals[k]];
+            const int start = ((csr.getY(s) - cy) << CLUSTER_SHIFT) + csr.getX(s) - cx;
+            local[start] = 0;
+            queue.assign(1, start);
+            for (size_t head = 0; head < queue.size(); ++head) {
+                const int u = queue[head];
+                const int ux = u & (CLUSTER - 1);
+                const int uy = u >> CLUSTER_SHIFT;
+                for (auto &o : offsets) {
+                    const int x = ux + o[0];
+                    const int y = uy + o[1];
+                    if (x < 0 || x >= cw || y < 0 || y >= ch) continue;
+                    const int v = (y << CLUSTER_SHIFT) + x;
+                    if (local[v] != FAR || !bfs.isOpen(cx + x, cy + y)) continue;
+                    local[v] = local[u] + 1;
+                    queue.push_back(v);
+                }
+            }
+            for (size_t l = 0; l < cluster.portals.size(); ++l) {
+                const int t = a->portal_node[cluster.portals[l]];
+                const uint16_t d = local[((csr.getY(t) - cy) << CLUSTER_SHIFT) + csr.getX(t) - cx];
+                if (l != k && d != FAR) a->edges[cluster.portals[k]].push_back({cluster.portals[l], d});
+            }
+        }
+    }
+    return a;
+}
+
+void HierarchicalDistanceOracle::setGoal(int i, int shape_class, const GridBFS &bfs, int goal)
+{
+    if (abstractions[shape_class] == nullptr) abstractions[shape_class] = buildAbstraction(bfs);
+    const Abstraction &a = *abstractions[shape_class];
+    GoalDistances &g = goals[i];
+    g.shape_class = shape_class;
+
+    // BFS from the goal inside of the window, the goal is expanded even if blocked
+    const int gx = csr.getX(goal);
+    const int gy = csr.getY(goal);
+    g.x0 = std::max(0, gx - NEAR_RADIUS);
+    g.y0 = std::max(0, gy - NEAR_RADIUS);
+    g.w = std::min(width - 1, gx + NEAR_RADIUS) - g.x0 + 1;
+    g.h = std::min(height - 1, gy + NEAR_RADIUS) - g.y0 + 1;
+    g.near.assign(g.w * g.h, FAR);
+    const int offsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    std::vector<int> queue(1, (gy - g.y0) * g.w + gx - g.x0);
+    g.near[queue[0]] = 0;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const int u = queue[head];
+        const int ux = u % g.w;
+        const int uy = u / g.w;
+        for (auto &o : offsets) {
+            const int x = ux + o[0];
+            const int y = uy + o[1];
+            if (x < 0 || x >= g.w || y < 0 || y >= g.h) continue;
+            const int v = y * g.w + x;
+            if (g.near[v] != FAR || !bfs.isOpen(g.x0 + x, g.y0 + y)) continue;
+            g.near[v] = g.near[u] + 1;
+            queue.push_back(v);
+        }
+    }
+
+    // Dijkstra over the portals, from those reached in the window
+    using Entry = std::pair<int, int>; // distance, portal
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    g.portal_dist.assign(a.portal_node.size(), INT_MAX);
+    for (int cy = g.y0 >> CLUSTER_SHIFT; cy <= (g.y0 + g.h - 1) >> CLUSTER_SHIFT; ++cy) {
+        for (int cx = g.x0 >> CLUSTER_SHIFT; cx <= (g.x0 + g.w - 1) >> CLUSTER_SHIFT; ++cx) {
+            for (auto p : a.clusters[cy * columns + cx].portals) {
+                const int x = csr.getX(a.portal_node[p]) - g.x0;
+                const int y = csr.getY(a.portal_node[p]) - g.y0;
+                if (x < 0 || x >= g.w || y < 0 || y >= g.h || g.near[y * g.w + x] == FAR) continue;
+                g.portal_dist[p] = g.near[y * g.w + x];
+                open.push({g.portal_dist[p], p});
+            }
+        }
+    }
+    while (!open.empty()) {
+        const auto [d, p] = open.top();
+        open.pop();
+        if (d != g.portal_dist[p]) continue;
+        for (auto &e : a.edges[p]) {
+            if (d + e.cost >= g.portal_dist[e.to]) continue;
+            g.portal_dist[e.to] = d + e.cost;
+            open.push({d + e.cost, e.to});
+        }
+    }
+}
+
+int HierarchicalDistanceOracle::getDistance(int i, int id) const
+{
+    const GoalDistances &g = goals[i];
+    const int x = csr.getX(id);
+    const int y = csr.getY(id);
+    int best = INT_MAX;
+    const int wx = x - g.x0;
+    const int wy = y - g.y0;
+    if (wx >= 0 && wx < g.w && wy >= 0 && wy < g.h && g.near[wy * g.w + wx] != FAR)
+        best = g.near[wy * g.w + wx];
+
+    const Abstraction &a = *abstractions[g.shape_class];
+    const auto &cluster = a.clusters[(y >> CLUSTER_SHIFT) * columns + (x >> CLUSTER_SHIFT)];
+    const uint16_t *local = &a.local[cluster.first + ((y & (CLUSTER - 1)) << CLUSTER_SHIFT) +
+                                     (x & (CLUSTER - 1))];
+    for (auto p : cluster.portals) {
+        const int d = g.portal_dist[p];
+        if (*local != FAR && d != INT_MAX) best = std::min(best, *local + d);
+        local += CLUSTER * CLUSTER;
+    }
+    return best == INT_MAX ? unreachable : best;
+}
+
+size_t HierarchicalDistanceOracle::getMemory() const
+{
+    size_t bytes = 0;
+    for (auto &a : abstractions)
+        if (a != nullptr) bytes += a->getMemory();
+    for (auto &g : goals)
+        bytes += sizeof(g) + g.near.size() * sizeof(uint16_t) + g.portal_dist.size() * sizeof(int);
+    return bytes;
+}
@@ -0,0 +1,86 @@
+#include "../include/distance_table_cache.hpp"
+
+size_t DistanceTableCache::KeyHash::operator()(const Key &key) const
+{
+    size_t h = std::hash<std::string>()(key.map_file);
+    h ^= std::hash<int>()(key.goal) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<int>()(int(key.footprint.kind)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<float>()(key.footprint.w) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<float>()(key.footprint.h) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<int>()(key.max_timestep) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    return h;
+}
+
+DistanceTableCache::DistanceTableCache(size_t budget_bytes) : budget(budget_bytes) {}
+
+void DistanceTableCache::get(const Key &key, Table &table,
+                             const std::function<void(Table &)> &compute)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto itr = index.find(key);
+        if (itr != index.end()) {
+            ++hits;
+            entries.splice(entries.begin(), entries, itr->second);
+            table = itr->second->table;
+            return;
+        }
+        ++misses;
+    }
+
+    compute(table);
+    if (tableBytes(table) > budget) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (index.count(key)) return; // computed by another thread meanwhile
+    entries.push_front({key, table});
+    index[key] = entries.begin();
+    bytes += tableBytes(table);
+    evict();
+}
+
+void DistanceTableCache::evict()
+{
+    while (bytes > budget && !entries.empty()) {
+        const Entry &entry = entries.back();
+        bytes -= tableBytes(entry.table);
+        index.erase(entry.key);
+        entries.pop_back();
+        ++evictions;
+    }
+}
+
+long long DistanceTableCache::getHits() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+long long DistanceTableCache::getMisses() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+long long DistanceTableCache::getEvictions() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return evictions;
+}
+
+size_t DistanceTableCache::getBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytes;
+}
+
+void DistanceTableCache::write(std::ostream &log) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    log << "distance_table_cache_budget=" << budget << "\n";
+    log << "distance_table_cache_bytes=" << bytes << "\n";
+    log << "distance_table_cache_tables=" << entries.size() << "\n";
+    log << "distance_table_cache_hits=" << hits << "\n";
+    log << "distance_table_cache_misses=" << misses << "\n";
+    log << "distance_table_cache_evictions=" << evictions << "\n";
+}
@@ -1,22 +1,56 @@
 #include <iostream>
+#include <sstream>
 #include "../include/graph_utils.hpp"
 
 bool checkIfNodeExistInRadiusOnGrid(Graph* G, int x, int y, float s) {
-    int size = ceil(s);
+    return fitsBox(G, x, y, AgentShape::make(ShapeKind::SQUARE, s));
+};
 
-    if (size == 0) {
-        return G->existNode(x, y);
+ShapeKind getShapeKind(const AgentShapes& shapes) {
+    if (shapes.empty()) return ShapeKind::SQUARE;
+    for (auto& s : shapes)
+        if (s.kind != shapes[0].kind) return ShapeKind::MIXED;
+    return shapes[0].kind;
+}
+
+static const char* SHAPE_NAMES[] = {"square", "circle", "rect", "mixed"};
+
+bool parseShape(const std::string& name, ShapeKind& kind) {
+    for (auto k : {ShapeKind::SQUARE, ShapeKind::CIRCLE, ShapeKind::RECT}) {
+        if (name != SHAPE_NAMES[int(k)]) continue;
+        kind = k;
+        return true;
     }
+    return false;
+}
+
+std::string getShapeName(ShapeKind kind) {
+    return SHAPE_NAMES[int(kind)];
+}
 
-    for (int delta = 0; delta <= size; delta ++) {
-        if (!G->existNode(x + delta, y) ||
-            !G->existNode(x + delta, y + size) ||
-            !G->existNode(x , y + delta) ||
-            !G->existNode(x + size, y + delta)
-            )  {
-            return false;
-        }
+void parseSize(const std::string& name, float& w, float& h) {
+    const std::size_t pos = name.find('x');
+    w = std::stof(name.substr(0, pos));
+    h = pos == std::string::npos ? -1 : std::stof(name.substr(pos + 1));
+}
+
+bool makeAgentShapes(const std::vector<float>& widths, const std::vector<float>& heights,
+                     ShapeKind default_kind, const std::vector<ShapeKind>& kinds,
+                     AgentShapes& shapes) {
+    shapes.clear();
+    for (size_t i = 0; i < widths.size(); ++i) {
+        const float h = i < heights.size() ? heights[i] : -1;
+        ShapeKind kind = h >= 0 ? ShapeKind::RECT : default_kind;
+        if (i < kinds.size()) kind = kinds[i];
+        if (h >= 0 && h != widths[i] && kind != ShapeKind::RECT) return false;
+        shapes.push_back({kind, widths[i], h >= 0 ? h : widths[i]});
     }
-    
     return true;
-};
\ No newline at end of file
+}
+
+std::string getSizeName(const AgentShape& shape) {
+    std::stringstream name;
+    name << shape.w;
+    if (shape.kind == ShapeKind::RECT) name << "x" << shape.h;
+    return name.str();
+}
@@ -0,0 +1,149 @@
+#include <algorithm>
+
+#include "../include/grid_bfs.hpp"
+
+GridBFS::GridBFS(Grid *grid, const GridCSR &csr, const AgentShape &shape)
+    : width(grid->getWidth()), height(grid->getHeight()), words((width + 63) / 64),
+      open(words * height, 0), padded_open((width + 2) * (height + 2), 0),
+      padded_id((width + 2) * (height + 2), -1), padded_component((width + 2) * (height + 2), -1)
+{
+    for (int id = 0; id < csr.size(); ++id) {
+        if (!csr.existNode(id)) continue;
+        const int x = csr.getX(id);
+        const int y = csr.getY(id);
+        padded_id[(y + 1) * (width + 2) + x + 1] = id;
+        if (!fitsShape(grid, x, y, shape)) continue;
+        open[y * words + (x >> 6)] |= uint64_t(1) << (x & 63);
+        ++open_cells;
+        padded_open[(y + 1) * (width + 2) + x + 1] = 1;
+    }
+
+    // flood fill of every component from its first cell
+    const int stride = width + 2;
+    const int offsets[4] = {-1, 1, -stride, stride};
+    std::vector<int> queue;
+    int components = 0;
+    for (int p = 0; p < (int)padded_open.size(); ++p) {
+        if (!padded_open[p] || padded_component[p] != -1) continue;
+        padded_component[p] = components;
+        queue.assign(1, p);
+        for (size_t head = 0; head < queue.size(); ++head) {
+            for (auto o : offsets) {
+                const int q = queue[head] + o;
+                if (!padded_open[q] || padded_component[q] != -1) continue;
+                padded_component[q] = components;
+                queue.push_back(q);
+            }
+        }
+        ++components;
+    }
+}
+
+bool GridBFS::isConnected(int id, int goal) const
+{
+    if (id == goal) return true;
+    const int stride = width + 2;
+    const int p = (id / width + 1) * stride + id % width + 1;
+    const int g = (goal / width + 1) * stride + goal % width + 1;
+    const int c = padded_component[p];
+    if (c == -1) return false;
+    if (padded_open[g]) return padded_component[g] == c;
+    // a goal where the footprint does not fit is still left to its open neighbours
+    for (auto o : {-1, 1, -stride, stride})
+        if (padded_component[g + o] == c) return true;
+    return false;
+}
+
+void GridBFS::run(int goal, int unreachable, std::vector<int> &table) const
+{
+    table.assign(width * height, unreachable);
+    table[goal] = 0;
+
+    // frontier and next are zero outside of the rows they span
+    std::vector<uint64_t> visited(open.size(), 0);
+    std::vector<uint64_t> frontier(open.size(), 0);
+    std::vector<uint64_t> next(open.size(), 0);
+    const int gx = goal % width;
+    const int gy = goal / width;
+    visited[gy * words + (gx >> 6)] |= uint64_t(1) << (gx & 63);
+    frontier[gy * words + (gx >> 6)] |= uint64_t(1) << (gx & 63);
+
+    int y0 = gy, y1 = gy; // rows of the frontier
+    // cells further than unreachable - 1 steps keep unreachable, as they would with a queue
+    for (int d = 1; d < unreachable && y0 <= y1; ++d) {
+        int next_y0 = height, next_y1 = -1;
+        for (int y = std::max(0, y0 - 1); y <= std::min(height - 1, y1 + 1); ++y) {
+            const uint64_t *row = &frontier[y * words];
+            const uint64_t *above = y > 0 ? &frontier[(y - 1) * words] : nullptr;
+            const uint64_t *below = y + 1 < height ? &frontier[(y + 1) * words] : nullptr;
+            for (int w = 0; w < words; ++w) {
+                uint64_t n = (row[w] << 1) | (row[w] >> 1);
+                if (w > 0) n |= row[w - 1] >> 63;
+                if (w + 1 < words) n |= row[w + 1] << 63;
+                if (above != nullptr) n |= above[w];
+                if (below != nullptr) n |= below[w];
+                const int k = y * words + w;
+                n &= open[k] & ~visited[k];
+                if (n == 0) continue;
+                next[k] = n;
+                visited[k] |= n;
+                next_y0 = std::min(next_y0, y);
+                next_y1 = std::max(next_y1, y);
+                int *cells = &table[y * width + (w << 6)];
+                for (; n != 0; n &= n - 1) cells[__builtin_ctzll(n)] = d;
+            }
+        }
+        std::fill(frontier.begin() + y0 * words, frontier.begin() + (y1 + 1) * words, 0);
+        frontier.swap(next);
+        y0 = next_y0;
+        y1 = next_y1;
+    }
+}
+
+void GridBFS::runBatch(const int *goals, int count, int unreachable,
+                       std::vector<int> *const *tables) const
+{
+    const int stride = width + 2;
+    const int offsets[4] = {-1, 1, -stride, stride};
+
+    // per padded cell, bit k for goals[k]
+    std::vector<uint64_t> visited(padded_open.size(), 0);
+    std::vector<uint64_t> frontier(padded_open.size(), 0);
+    std::vector<uint64_t> reached(padded_open.size(), 0);
+    std::vector<int> cells;      // with a frontier
+    std::vector<int> next_cells; // with a frontier on the next level
+    int *data[MAX_BATCH];
+    for (int k = 0; k < count; ++k) {
+        tables[k]->assign(width * height, unreachable);
+        data[k] = tables[k]->data();
+        data[k][goals[k]] = 0;
+        const int p = (goals[k] / width + 1) * stride + goals[k] % width + 1;
+        if (frontier[p] == 0) cells.push_back(p);
+        frontier[p] |= uint64_t(1) << k;
+        visited[p] |= uint64_t(1) << k;
+    }
+
+    for (int d = 1; d < unreachable && !cells.empty(); ++d) {
+        for (auto p : cells) {
+            const uint64_t f = frontier[p];
+            for (auto o : offsets) {
+                const int q = p + o;
+                if (!padded_open[q]) continue;
+                const uint64_t n = f & ~visited[q];
+                if (n == 0) continue;
+                if (reached[q] == 0) next_cells.push_back(q);
+                reached[q] |= n;
+                visited[q] |= n;
+            }
+        }
+        for (auto p : cells) frontier[p] = 0;
+        for (auto q : next_cells) {
+            const int id = padded_id[q];
+            for (uint64_t n = reached[q]; n != 0; n &= n - 1) data[__builtin_ctzll(n)][id] = d;
+            frontier[q] = reached[q];
+            reached[q] = 0;
+        }
+        cells.swap(next_cells);
+        next_cells.clear();
+    }
+}
@@ -0,0 +1,44 @@
+#include <cmath>
+
+#include "../include/grid_csr.hpp"
+
+GridCSR::GridCSR(Graph *G)
+{
+    const int size = G->getNodesSize();
+    offsets.reserve(size + 1);
+    xs.assign(size, -1);
+    ys.assign(size, -1);
+    nodes.assign(size, nullptr);
+    offsets.push_back(0);
+    for (int id = 0; id < size; ++id) {
+        if (G->existNode(id)) {
+            Node *v = G->getNode(id);
+            nodes[id] = v;
+            xs[id] = v->pos.x;
+            ys[id] = v->pos.y;
+            for (auto u : v->neighbor) adjacency.push_back(u->id);
+        }
+        offsets.push_back(adjacency.size());
+    }
+    adjacency.shrink_to_fit();
+}
+
+bool GridCSR::isNeighbor(int u, int v) const
+{
+    for (auto w : getNeighbors(u))
+        if (w == v) return true;
+    return false;
+}
+
+float GridCSR::euclideanDist(int u, int v) const
+{
+    const float dx = xs[u] - xs[v];
+    const float dy = ys[u] - ys[v];
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+size_t GridCSR::getMemory() const
+{
+    return (offsets.size() + adjacency.size() + xs.size() + ys.size()) * sizeof(int) +
+           nodes.size() * sizeof(Node *);
+}
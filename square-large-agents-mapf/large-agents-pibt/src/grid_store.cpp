@@ -0,0 +1,53 @@
+#include <cstdint>
+#include <fstream>
+#include <regex>
+
+#include "../include/grid_store.hpp"
+
+bool GridStore::isValidMap(std::istream &file)
+{
+    std::string line;
+    std::smatch results;
+    std::regex r_height = std::regex(R"(height\s(\d{1,9}))");
+    std::regex r_width = std::regex(R"(width\s(\d{1,9}))");
+    std::regex r_map = std::regex(R"(map)");
+    long width = 0, height = 0;
+    bool map = false;
+    while (!map && getline(file, line)) {
+        if (!line.empty() && line.back() == 0x0d) line.pop_back();
+        // at most 9 digits, no overflow
+        if (std::regex_match(line, results, r_height)) height = std::stol(results[1].str());
+        if (std::regex_match(line, results, r_width)) width = std::stol(results[1].str());
+        map = std::regex_match(line, results, r_map);
+    }
+    if (!map || width <= 0 || height <= 0 || width * height > INT32_MAX) return false;
+
+    long rows = 0;
+    while (getline(file, line)) {
+        if (!line.empty() && line.back() == 0x0d) line.pop_back();
+        if ((long)line.size() != width) return false;
+        ++rows;
+    }
+    return rows == height;
+}
+
+Grid *GridStore::get(const std::string &map_file)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto itr = grids.find(map_file);
+    if (itr != grids.end()) return itr->second.get();
+
+    // Grid halts on a missing or broken file
+    std::ifstream file(map_file);
+    if (!file) file.open(std::string(_MAPDIR_) + map_file);
+    if (!file || !isValidMap(file)) return nullptr;
+    Grid *grid = new Grid(map_file);
+    grids[map_file] = std::unique_ptr<Grid>(grid);
+    return grid;
+}
+
+int GridStore::size()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return grids.size();
+}
@@ -1,5 +1,4 @@
 #include <algorithm>
-#include <map>
 #include <exception>
 #include <unordered_set>
 #include <stdexcept>
@@ -7,35 +6,46 @@
 #include "../include/lapibt.hpp"
 #include "../include/exceptions.hpp"
 
-const std::string LAPIBT::SOLVER_NAME = "Free Space Priority Inheritance With Backtracking V2 (LAPIBT)";
+template <class Shape>
+const std::string LAPIBT<Shape>::SOLVER_NAME = "Free Space Priority Inheritance With Backtracking V2 (LAPIBT)";
 
 
-LAPIBT::LAPIBT(LargeAgentsMapfProblem *problem, int inheritanceDepth)
+template <class Shape>
+LAPIBT<Shape>::LAPIBT(LargeAgentsMapfProblem *problem, int inheritanceDepth)
     : LargeAgentsMAPFSolver(problem), inheritanceDepth(inheritanceDepth),
-      setOfAgentsInConflict()
+      setOfAgentsInConflict(), initial_inheritanceDepth(inheritanceDepth)
 {
-    solver_name = LAPIBT::SOLVER_NAME;
+    solver_name = LAPIBT<Shape>::SOLVER_NAME;
 }
 
 
-LAPIBT::LAPIBT(LargeAgentsMapfProblem *problem)
-    : LargeAgentsMAPFSolver(problem), setOfAgentsInConflict(), inheritanceDepth(5)
+template <class Shape>
+LAPIBT<Shape>::LAPIBT(LargeAgentsMapfProblem *problem)
+    : LargeAgentsMAPFSolver(problem), setOfAgentsInConflict(), inheritanceDepth(5),
+      initial_inheritanceDepth(5)
 {
-    solver_name = LAPIBT::SOLVER_NAME;
+    solver_name = LAPIBT<Shape>::SOLVER_NAME;
 }
 
-void LAPIBT::run()
+template <class Shape>
+LAPIBT<Shape>::~LAPIBT()
 {
-    auto compareAllAgents = [](Agent *agent_lhs, const Agent *agent_rhs)
-    {
-        if (agent_lhs->elapsed != agent_rhs->elapsed)
-            return agent_lhs->elapsed > agent_rhs->elapsed;
-        if (agent_lhs->init_d != agent_rhs->init_d)
-            return agent_lhs->init_d > agent_rhs->init_d;
-        return agent_lhs->tie_breaker > agent_rhs->tie_breaker;
-    };
+    for (auto a : allAgents)
+        delete a;
+}
 
-    std::vector<Agent *> allAgents;
+template <class Shape>
+bool LAPIBT<Shape>::initializeSolver()
+{
+    for (auto a : allAgents)
+        delete a;
+    allAgents.clear();
+    solution.clear();
+    solved = false;
+    timestep = 0;
+    inheritanceDepth = initial_inheritanceDepth;
+    best_progress = -1;
+    restart_timesteps.clear();
 
     for (int i = 0; i < P->getNum(); ++i)
     {
@@ -46,7 +56,7 @@ void LAPIBT::run()
         {
             std::cout << "Goal for agent " << i << " is unreachable";
             solved = false;
-            return;
+            return false;
         }
 
         auto *agent = new Agent{
@@ -56,130 +66,274 @@ void LAPIBT::run()
             0,                        // eta
             d,                        // initial distance
             getRandomFloat(0, 1, MT), // epsilon, tie-breaker
-            P->getSize(i)             // Size (radius) of an agent
+            P->getSize(i),            // Size (radius) of an agent
+            P->getAgentShape(i)       // Shape of an agent
         };
         allAgents.push_back(agent);
     }
 
+    raster.reset();
+    if (conflict_backend == ConflictBackend::RASTER)
+        raster = std::make_unique<OccupancyRaster>(P->getGrid(), P->getAgentShapes());
+    changed_agents.clear();
+    is_changed.assign(P->getNum(), 0);
+
     solution.add(P->getConfigStart());
+    return true;
+}
 
-    int timestep = 0;
+template <class Shape>
+void LAPIBT<Shape>::pathChanged(Agent *agent)
+{
+    if (!raster || is_changed[agent->id]) return;
+    is_changed[agent->id] = 1;
+    changed_agents.push_back(agent);
+}
 
-    while (true)
-    {
-        ++timestep;
-        info(" ", "elapsed:", getSolverElapsedTime(), ", timestep:", timestep);
+template <class Shape>
+void LAPIBT<Shape>::syncRaster(Agent *agent)
+{
+    pathChanged(agent);
+    for (auto a : changed_agents) {
+        size_t len = (a->path).size();
+        if (a == agent) --len;
+        if (setOfAgentsInConflict.find(a) != setOfAgentsInConflict.end()) len = 0;
+        raster->setPath(a->id, a->path, len);
+        is_changed[a->id] = 0;
+    }
+    changed_agents.clear();
+    pathChanged(agent); // its last node is missing
+}
 
-        std::sort(allAgents.begin(), allAgents.end(), compareAllAgents);
+template <class Shape>
+void LAPIBT<Shape>::run()
+{
+    if (!initializeSolver())
+        return;
 
-        for (auto agent : allAgents)
-        {
-            if ((agent->path).size() == 1){
-                try {
-                    mainLAPIBT(agent, allAgents);
-                } catch (too_high_compute_time_exception& e) {
-                    info("Exception caught, Message: ", e.message());
-                    for (auto a : allAgents)
-                        delete a;
-                    return;
-                }
-            }
+    while (true)
+    {
+        try {
+            step();
+        } catch (too_high_compute_time_exception& e) {
+            info("Exception caught, Message: ", e.message());
+            return;
         }
 
-        bool check_goal_condition = true;
-
-        std::vector<Node *> configuration(P->getNum(), nullptr);
+        if (solved)
+            break;
 
-        for (auto agent : allAgents)
+        if (timestep >= max_timestep)
         {
-            Node *agents_next_node = *((agent->path).begin() + 1);
-            bool elapsed = (agents_next_node == agent->goal);
-
-            configuration[agent->id] = agents_next_node;
-            (agent->path).pop_front();
-
-            agent->elapsed = elapsed ? 0 : agent->elapsed + 1;
-            check_goal_condition &= elapsed;
+            info("Too much steps!");
+            break;
         }
 
-        solution.add(configuration);
-
-        if (check_goal_condition)
+        if (getSolverElapsedTime() > max_comp_time)
         {
-            solved = true;
+            info("Computation time is too big!");
             break;
         }
 
-        if (timestep >= max_timestep)
+        if (isCancelled())
         {
-            info("Too much steps!");
+            info("Cancelled!");
             break;
         }
 
-        if (getSolverElapsedTime() > max_comp_time)
+    }
+
+    info(" ", "timestep planning latency (us), p50:", stats.getTimestepTimePercentile(0.5),
+         ", p99:", stats.getTimestepTimePercentile(0.99));
+}
+
+template <class Shape>
+Config LAPIBT<Shape>::step()
+{
+    auto compareAllAgents = [](Agent *agent_lhs, const Agent *agent_rhs)
+    {
+        if (agent_lhs->elapsed != agent_rhs->elapsed)
+            return agent_lhs->elapsed > agent_rhs->elapsed;
+        if (agent_lhs->init_d != agent_rhs->init_d)
+            return agent_lhs->init_d > agent_rhs->init_d;
+        return agent_lhs->tie_breaker > agent_rhs->tie_breaker;
+    };
+
+    ++timestep;
+    info(" ", "elapsed:", getSolverElapsedTime(), ", timestep:", timestep);
+    syncDistanceTables();
+    auto t_timestep_start = Time::now();
+    timestep_deadline = t_timestep_start + std::chrono::milliseconds(timestep_budget);
+    TraceSpan timestep_span(trace, "timestep", "timestep", "timestep", timestep);
+
+    {
+        TraceSpan span(trace, "sort", "timestep");
+        std::sort(allAgents.begin(), allAgents.end(), compareAllAgents);
+    }
+
+    // the paths moved by one offset since the last timestep
+    step_paths.clear();
+    for (auto agent : allAgents)
+    {
+        pathChanged(agent);
+        step_paths.push_back({agent, (agent->path).size(), (agent->path).back()});
+    }
+
+    try {
+        for (auto agent : allAgents)
         {
-            info("Computation time is too big!");
-            break;
+            if ((agent->path).size() == 1){
+                TraceSpan span(trace, "mainLAPIBT", "agent", "agent", agent->id);
+                mainLAPIBT(agent, allAgents);
+            }
         }
+    } catch (too_high_compute_time_exception &e) {
+        // some agents have moved on and others not, back to the start of the timestep
+        saved_paths = step_paths;
+        restorePaths(0);
+        setOfAgentsInConflict.clear();
+        --timestep;
+        throw;
+    }
+
+    TraceSpan commit_span(trace, "commit", "timestep");
+    bool check_goal_condition = true;
+
+    std::vector<Node *> configuration(P->getNum(), nullptr);
+
+    for (auto agent : allAgents)
+    {
+        Node *agents_next_node = *((agent->path).begin() + 1);
+        bool elapsed = (agents_next_node == agent->goal);
 
+        configuration[agent->id] = agents_next_node;
+        (agent->path).pop_front();
+
+        agent->elapsed = elapsed ? 0 : agent->elapsed + 1;
+        check_goal_condition &= elapsed;
     }
 
-    for (auto a : allAgents)
-        delete a;
+    solution.add(configuration);
+    solved = check_goal_condition;
+    if (stall_window > 0 && !solved) checkStall(configuration);
+    stats.recordTimestepTime(t_timestep_start);
+
+    return configuration;
+}
+
+template <class Shape>
+void LAPIBT<Shape>::checkStall(const Config &configuration)
+{
+    int progress = 0;
+    for (int i = 0; i < P->getNum(); ++i)
+        progress += pathDist(i, configuration[i]);
+
+    if (best_progress == -1 || progress < best_progress) {
+        best_progress = progress;
+        last_progress_timestep = timestep;
+        window_dists.resize(P->getNum());
+        for (int i = 0; i < P->getNum(); ++i)
+            window_dists[i] = pathDist(i, configuration[i]);
+        return;
+    }
+    if (timestep - last_progress_timestep >= stall_window) restart(configuration);
+}
+
+template <class Shape>
+void LAPIBT<Shape>::restart(const Config &configuration)
+{
+    TraceSpan span(trace, "restart", "timestep", "timestep", timestep);
+    info(" ", "no progress for ", stall_window, " timesteps, restart");
+    restart_timesteps.push_back(timestep);
+
+    // next inheritance depth of D, D/2, 2D
+    const int depths[] = {initial_inheritanceDepth, std::max(1, initial_inheritanceDepth / 2),
+                          2 * initial_inheritanceDepth};
+    inheritanceDepth = depths[restart_timesteps.size() % 3];
+
+    for (auto agent : allAgents) {
+        agent->tie_breaker = getRandomFloat(0, 1, MT);
+        // blocked agents, no closer to their goal than at the last progress, go first
+        const int i = agent->id;
+        if (configuration[i] != agent->goal && pathDist(i, configuration[i]) >= window_dists[i])
+            agent->elapsed += stall_window;
+    }
+
+    // the configuration of the restart is the new reference
+    best_progress = -1;
+}
+
+template <class Shape>
+void LAPIBT<Shape>::updateGoal(int i, Node *g)
+{
+    LargeAgentsMAPFSolver::updateGoal(i, g);
+
+    for (auto agent : allAgents)
+    {
+        if (agent->id != i)
+            continue;
+        agent->goal = g;
+        agent->elapsed = 0;
+        agent->init_d = disable_dist_init ? 0 : pathDist(i, (agent->path).back());
+    }
+    solved = false;
+    best_progress = -1; // distances to the new goal are not comparable
 }
 
-void LAPIBT::mainLAPIBT(Agent *agent, const std::vector<Agent *> &allAgents)
+template <class Shape>
+void LAPIBT<Shape>::mainLAPIBT(Agent *agent, const std::vector<Agent *> &allAgents)
 {
     if (agent->goal == (agent->path).back())
     {
         (agent->path).push_back((agent->path).back());
+        pathChanged(agent);
         return;
     };
 
-    auto closestNodeToTheGoal = [&, agent](Node *const node_lhs, Node *const node_rhs)
-    {
-        auto distance_node_lhs = pathDist(agent->id, node_lhs);
-        auto distance_node_rhs = pathDist(agent->id, node_rhs);
-        return distance_node_lhs < distance_node_rhs;
-    };
+    // closest to the goal first
+    const Successors current_nodes_neighbours = getSuccessors(agent->id, (agent->path).back());
 
-    std::vector<Node *> current_nodes_neighbours = (agent->path).back()->neighbor;
-    std::sort(current_nodes_neighbours.begin(), current_nodes_neighbours.end(), closestNodeToTheGoal);
-    
     for (auto perpective_next_node : current_nodes_neighbours)
     {
         if (pathDist(agent->id, perpective_next_node) == max_timestep + 1)
             continue;
 
         (agent->path).push_back(perpective_next_node);
+        pathChanged(agent);
 
         if (collisionConflict(agent, allAgents))
         {
             (agent->path).pop_back();
+            pathChanged(agent);
             continue;
         }
 
-        if (
-            inheritanceConflict(agent, allAgents) &&
-            solveInheritanceConflict(agent, allAgents).empty())
+        if (inheritanceConflict(agent, allAgents))
         {
-            (agent->path).pop_back();
-            continue;
+            const bool solved = solveInheritanceConflict(agent, allAgents);
+            saved_paths.clear();
+            if (!solved)
+            {
+                (agent->path).pop_back();
+                pathChanged(agent);
+                continue;
+            }
         }
 
         return;
     }
 
     (agent->path).push_back((agent->path).back());
+    pathChanged(agent);
 }
 
-bool LAPIBT::collisionConflict(Agent *child_agent, Agent* parent_agent, const std::vector<Agent *> &allAgents)
+template <class Shape>
+bool LAPIBT<Shape>::collisionConflict(Agent *child_agent, Agent* parent_agent, const std::vector<Agent *> &allAgents)
 {
     checkIfComputationTimeExceeded();
+    LAPIBT_STAT(stats.collision_conflict_in_inheritance_calls++);
 
-    int child_agent_pos_x = child_agent->path.back()->pos.x;
-    int child_agent_pos_y = child_agent->path.back()->pos.y;
-    float child_agent_size = ceil(child_agent->size);
+    const Pos &child_agent_pos = child_agent->path.back()->pos;
 
     for (auto other_agent : setOfAgentsInConflict)
     {
@@ -189,29 +343,28 @@ bool LAPIBT::collisionConflict(Agent *child_agent, Agent* parent_agent, const st
             node_in_other_agents_path != (other_agent->path).end() - offset;
             node_in_other_agents_path++)
         {
-            int other_agent_pos_x = (*node_in_other_agents_path)->pos.x;
-            int other_agent_pos_y = (*node_in_other_agents_path)->pos.y;
-            float other_agent_size = ceil(other_agent->size);
-
-            if (
-                child_agent_pos_x > other_agent_pos_x - child_agent_size &&
-                child_agent_pos_x < other_agent_pos_x + other_agent_size &&
-                child_agent_pos_y > other_agent_pos_y - child_agent_size &&
-                child_agent_pos_y < other_agent_pos_y + other_agent_size
-            )
+            if (Shape::overlap(child_agent_pos, child_agent->shape,
+                               (*node_in_other_agents_path)->pos, other_agent->shape))
                 return true;
         }
     }
     return false;
 }
 
-bool LAPIBT::collisionConflict(Agent *agent, const std::vector<Agent *> &allAgents)
+template <class Shape>
+bool LAPIBT<Shape>::collisionConflict(Agent *agent, const std::vector<Agent *> &allAgents)
 {
     checkIfComputationTimeExceeded();
+    LAPIBT_STAT(stats.collision_conflict_calls++);
 
-    int agent_pos_x = agent->path.back()->pos.x;
-    int agent_pos_y = agent->path.back()->pos.y;
-    float agent_size = ceil(agent->size);
+    const Pos &agent_pos = agent->path.back()->pos;
+
+    if (raster) {
+        syncRaster(agent);
+        if (!raster->intersects(agent->id, agent->path.back(), (agent->path).size() - 1))
+            return false;
+        LAPIBT_STAT(stats.raster_confirmations++);
+    }
 
     for (auto other_agent : allAgents)
     {
@@ -225,16 +378,8 @@ bool LAPIBT::collisionConflict(Agent *agent, const std::vector<Agent *> &allAgen
                 node_in_other_agents_path != (other_agent->path).end();
                 node_in_other_agents_path++)
             {
-                int other_agent_pos_x = (*node_in_other_agents_path)->pos.x;
-                int other_agent_pos_y = (*node_in_other_agents_path)->pos.y;
-                float other_agent_size = ceil(other_agent->size);
-
-                if (
-                    agent_pos_x > other_agent_pos_x - agent_size &&
-                    agent_pos_x < other_agent_pos_x + other_agent_size &&
-                    agent_pos_y > other_agent_pos_y - agent_size &&
-                    agent_pos_y < other_agent_pos_y + other_agent_size
-                )
+                if (Shape::overlap(agent_pos, agent->shape,
+                                   (*node_in_other_agents_path)->pos, other_agent->shape))
                     return true;
             }
         }
@@ -242,28 +387,20 @@ bool LAPIBT::collisionConflict(Agent *agent, const std::vector<Agent *> &allAgen
     return false;
 }
 
-bool LAPIBT::inheritanceConflict(Agent *agent, const std::vector<Agent *> &allAgents)
+template <class Shape>
+bool LAPIBT<Shape>::inheritanceConflict(Agent *agent, const std::vector<Agent *> &allAgents)
 {
     checkIfComputationTimeExceeded();
+    LAPIBT_STAT(stats.inheritance_conflict_calls++);
 
-    int agent_pos_x = agent->path.back()->pos.x;
-    int agent_pos_y = agent->path.back()->pos.y;
-    float agent_size = ceil(agent->size);
+    const Pos &agent_pos = agent->path.back()->pos;
     
     for (auto other_agent : allAgents)
     {
-        int other_agent_pos_x = ((other_agent->path).back())->pos.x;
-        int other_agent_pos_y = ((other_agent->path).back())->pos.y;
-        float other_agent_size = ceil(other_agent->size);
         if (
             other_agent->id != agent->id &&
             (other_agent->path).size() < (agent->path).size() &&
-            (
-                agent_pos_x > other_agent_pos_x - agent_size &&
-                agent_pos_x < other_agent_pos_x + other_agent_size &&
-                agent_pos_y > other_agent_pos_y - agent_size &&
-                agent_pos_y < other_agent_pos_y + other_agent_size
-            )
+            Shape::overlap(agent_pos, agent->shape, (other_agent->path).back()->pos, other_agent->shape)
         )
         {
             return true;
@@ -273,17 +410,20 @@ bool LAPIBT::inheritanceConflict(Agent *agent, const std::vector<Agent *> &allAg
     return false;
 }
 
-std::map<LAPIBT::Agent*, LAPIBT::PathState> LAPIBT::solveInheritanceConflict(Agent *agent, const std::vector<Agent *> &allAgents)
+template <class Shape>
+bool LAPIBT<Shape>::solveInheritanceConflict(Agent *agent, const std::vector<Agent *> &allAgents)
 {
     checkIfComputationTimeExceeded();
 
-    int agent_pos_x = agent->path.back()->pos.x;
-    int agent_pos_y = agent->path.back()->pos.y;
-    float agent_size = ceil(agent->size);
+    const Pos &agent_pos = agent->path.back()->pos;
     
+    TraceSpan span(trace, "solveInheritanceConflict", "inheritance", "agent", agent->id);
     setOfAgentsInConflict.insert(agent);
+    pathChanged(agent);
+    LAPIBT_STAT(stats.solve_inheritance_conflict_calls++);
+    LAPIBT_STAT(stats.recordInheritanceDepth(setOfAgentsInConflict.size()));
 
-    std::map<Agent*, PathState> path_states_before_conflict = {};
+    const size_t frame = saved_paths.size();
 
     auto agent_iterator = allAgents.begin();
     while (agent_iterator != allAgents.end())
@@ -291,61 +431,123 @@ std::map<LAPIBT::Agent*, LAPIBT::PathState> LAPIBT::solveInheritanceConflict(Age
         Agent *other_agent = *agent_iterator;
         agent_iterator++;
 
-        int other_agent_pos_x = ((other_agent->path).back())->pos.x;
-        int other_agent_pos_y = ((other_agent->path).back())->pos.y;
-        float other_agent_size = ceil(other_agent->size);
-
         if (
             other_agent->id != agent->id &&
             (other_agent->path).size() < (agent->path).size() &&
-            (
-                agent_pos_x > other_agent_pos_x - agent_size &&
-                agent_pos_x < other_agent_pos_x + other_agent_size &&
-                agent_pos_y > other_agent_pos_y - agent_size &&
-                agent_pos_y < other_agent_pos_y + other_agent_size
-            )
+            Shape::overlap(agent_pos, agent->shape, (other_agent->path).back()->pos, other_agent->shape)
         )
         {
-            std::map<Agent*, PathState> new_path_states_before_conflict = escapeInheritanceConflict(other_agent, agent, allAgents);
-
-            if (new_path_states_before_conflict.empty())
+            const size_t from = saved_paths.size();
+            if (!escapeInheritanceConflict(other_agent, agent, allAgents))
             {
-                for (auto const& [_agent, path_state] : path_states_before_conflict)
-                {
-                    (_agent->path).resize(path_state.size - 1);
-                    (_agent->path).push_back(path_state.last_node_in_path);
-                }
+                LAPIBT_STAT(stats.rollbacks += saved_paths.size() > frame);
+                restorePaths(frame);
 
                 setOfAgentsInConflict.erase(agent);
-                return {};
+                pathChanged(agent);
+                return false;
             }
             else
             {
-                for (auto const& [_agent, path_state] : new_path_states_before_conflict)
-                {
-                    if (path_states_before_conflict.find(_agent) == path_states_before_conflict.end()) {
-                        path_states_before_conflict[_agent] = path_state;
-                    }
-                }
+                mergePaths(frame, from);
                 agent_iterator = allAgents.begin();
             }
         }
     }
 
     setOfAgentsInConflict.erase(agent);
-    return path_states_before_conflict;
+    pathChanged(agent);
+    return true;
 }
 
-std::map<LAPIBT::Agent*, LAPIBT::PathState> LAPIBT::escapeInheritanceConflict(Agent *child_agent, Agent *parent_agent, const std::vector<Agent *> &allAgents)
+template <class Shape>
+bool LAPIBT<Shape>::escapeInheritanceConflict(Agent *child_agent, Agent *parent_agent, const std::vector<Agent *> &allAgents)
 {
+    TraceSpan span(trace, "escapeInheritanceConflict", "escape", "agent", child_agent->id);
+    LAPIBT_STAT(stats.escape_attempts++);
     if (setOfAgentsInConflict.size() > inheritanceDepth)
-        return {};
+    {
+        LAPIBT_STAT(stats.escape_depth_limit_hits++);
+        return false;
+    }
+
+    /// Out of timestep budget, the parent falls back to another move or waits
+    if (overTimestepBudget())
+    {
+        LAPIBT_STAT(stats.timestep_budget_fallbacks++);
+        return false;
+    }
+
+    if (escape_search == EscapeSearch::BFS)
+        return escapeAlongRoute(child_agent, parent_agent, allAgents);
+    return escapeGreedily(child_agent, parent_agent, allAgents);
+}
+
+template <class Shape>
+typename LAPIBT<Shape>::EscapeStep LAPIBT<Shape>::stepEscape(Agent *child_agent, Agent *parent_agent, Node *v, size_t frame, const std::vector<Agent *> &allAgents)
+{
+    (child_agent->path).push_back(v);
+    pathChanged(child_agent);
+    for (auto conflicting_agent: setOfAgentsInConflict) {
+        if (conflicting_agent->path.size() <= child_agent->path.size()) {
+            for (auto conflicting_agent: setOfAgentsInConflict) {
+                if (!isSaved(frame, saved_paths.size(), conflicting_agent)) {
+                    saved_paths.push_back({
+                        conflicting_agent,
+                        (conflicting_agent->path).size(),
+                        (conflicting_agent->path).back()
+                    });
+                }
+                conflicting_agent->wait();
+                pathChanged(conflicting_agent);
+            }
+        }
+    }
+
+    if (
+        collisionConflict(child_agent, allAgents) ||
+        collisionConflict(child_agent, parent_agent, allAgents)
+        )
+    {
+        (child_agent->path).pop_back();
+        pathChanged(child_agent);
+        return EscapeStep::COLLISION;
+    }
+
+    if (inheritanceConflict(child_agent, allAgents)){
+        const size_t from = saved_paths.size();
+        if (!solveInheritanceConflict(child_agent, allAgents))
+        {
+            (child_agent->path).pop_back();
+            pathChanged(child_agent);
+            return EscapeStep::BLOCKED;
+        }
+        mergePaths(frame, from);
+    }
+
+    for (size_t k = frame; k < saved_paths.size(); ++k) {
+        Agent *moved_agent = saved_paths[k].agent;
+        if (
+            setOfAgentsInConflict.find(moved_agent) == setOfAgentsInConflict.end() &&
+            moved_agent->id != child_agent->id
+        ) {
+            moved_agent->path.push_back(moved_agent->path.back());
+            pathChanged(moved_agent);
+        }
+    }
+    return EscapeStep::MOVED;
+}
 
-    Nodes nodes_outside_of_inheritance_conflict = getNodesToAvoidInheritanceConflict(child_agent, parent_agent);
+template <class Shape>
+bool LAPIBT<Shape>::escapeGreedily(Agent *child_agent, Agent *parent_agent, const std::vector<Agent *> &allAgents)
+{
+    const size_t frame = saved_paths.size();
+    const size_t first_target = escape_nodes.size();
+    getNodesToAvoidInheritanceConflict(child_agent, parent_agent, escape_nodes);
 
     std::sort(
-        nodes_outside_of_inheritance_conflict.begin(),
-        nodes_outside_of_inheritance_conflict.end(),
+        escape_nodes.begin() + first_target,
+        escape_nodes.end(),
         [&, child_agent](Node *const v, Node *const u)
     {
         auto d_v = (child_agent->path).back()->euclideanDist(v);
@@ -353,20 +555,28 @@ std::map<LAPIBT::Agent*, LAPIBT::PathState> LAPIBT::escapeInheritanceConflict(Ag
         return d_v < d_u;
     });
 
-    std::map<Agent*, PathState> path_states_before_conflict = {};
-    std::unordered_set<int> ids_of_visited_nodes = {};
+    // escapes further down the chain have more agents in conflict, so their own level
+    const int level = setOfAgentsInConflict.size();
     bool next_node_found_during_greedy_bfs = false;
-    int max_steps_allowed = 3*std::ceil(std::max(child_agent->size, parent_agent->size));
+    const int max_steps_allowed = Shape::escapeStepLimit(child_agent->size, parent_agent->size);
 
-    for (auto node_to_reach : nodes_outside_of_inheritance_conflict)
+    // by index, nested escapes grow escape_nodes
+    const size_t end_target = escape_nodes.size();
+    for (size_t target = first_target; target < end_target; ++target)
     {
-        if (
-            pathDist(child_agent->id, node_to_reach) == max_timestep + 1 ||
-            getRandomFloat(0., 1, MT) < 0.175 /// Is needed to prevent deadlocks
-        ) continue;
+        Node *node_to_reach = escape_nodes[target];
+        if (pathDist(child_agent->id, node_to_reach) == max_timestep + 1)
+            continue;
 
-        ids_of_visited_nodes.clear();
-        ids_of_visited_nodes.insert((child_agent->path).back()->id);
+        if (getRandomFloat(0., 1, MT) < Shape::ESCAPE_SKIP_PROBABILITY) /// Is needed to prevent deadlocks
+        {
+            LAPIBT_STAT(stats.escape_random_skips++);
+            continue;
+        }
+        LAPIBT_STAT(stats.escape_targets_tried++);
+
+        const unsigned generation = nextVisitedGeneration(level);
+        visited[level][(child_agent->path).back()->id] = generation;
 
         auto compareLocal = [node_to_reach](const Node *node_lhs, const Node *node_rhs)
         {
@@ -375,94 +585,49 @@ std::map<LAPIBT::Agent*, LAPIBT::PathState> LAPIBT::escapeInheritanceConflict(Ag
             return distance_node_lhs < distance_node_rhs;
         };
 
-        path_states_before_conflict[child_agent] = {
+        saved_paths.resize(frame);
+        saved_paths.push_back({
+            child_agent,
             (child_agent->path).size(),
             (child_agent->path).back()
-        };
+        });
         int step_counter = 0;
 
         while ((child_agent->path).back()->id != node_to_reach->id)
         {
             next_node_found_during_greedy_bfs = false;
-            Nodes neighbours = (child_agent->path).back()->neighbor;
-            std::sort(neighbours.begin(), neighbours.end(), compareLocal);
+            // insertion sort into a fixed array, stable as std::sort of up to 16 nodes
+            Successors neighbours;
+            for (auto id : csr.getNeighbors((child_agent->path).back()->id)) {
+                Node *v = csr.getNode(id);
+                int k = neighbours.size++;
+                for (; k > 0 && compareLocal(v, neighbours.nodes[k - 1]); --k)
+                    neighbours.nodes[k] = neighbours.nodes[k - 1];
+                neighbours.nodes[k] = v;
+            }
 
             for (auto neighbour_node : neighbours)
             {
                 if (
-                    ids_of_visited_nodes.find(neighbour_node->id) != ids_of_visited_nodes.end() ||
-                    !checkIfNodeExistInRadiusOnGrid(
-                        G,
-                        neighbour_node->pos.x,
-                        neighbour_node->pos.y,
-                        child_agent->size
-                    ))
+                    visited[level][neighbour_node->id] == generation ||
+                    !fits(child_agent->id, neighbour_node))
                 {
-                    ids_of_visited_nodes.insert(neighbour_node->id);
-                    continue;
+                    visited[level][neighbour_node->id] = generation;
+                    if (Shape::ESCAPE_ANY_NEIGHBOUR) continue;
+                    break;
                 }
 
-                if (step_counter > max_steps_allowed) {
+                if (step_counter > max_steps_allowed || overTimestepBudget()) {
                     break;
                 }
 
-                (child_agent->path).push_back(neighbour_node);
-                for (auto conflicting_agent: setOfAgentsInConflict) {
-                    if (conflicting_agent->path.size() <= child_agent->path.size()) {
-                        for (auto conflicting_agent: setOfAgentsInConflict) {
-                            if (
-                                path_states_before_conflict.find(conflicting_agent) ==
-                                path_states_before_conflict.end()
-                            ){
-                                path_states_before_conflict[conflicting_agent] = {
-                                    (conflicting_agent->path).size(),
-                                    (conflicting_agent->path).back()
-                                };
-                            }
-                            conflicting_agent->wait();
-                        }
-                    }
-                }
-                
-                if (
-                    collisionConflict(child_agent, allAgents) ||
-                    collisionConflict(child_agent, parent_agent, allAgents)
-                    )
-                {
-                    ids_of_visited_nodes.insert(neighbour_node->id);
-                    (child_agent->path).pop_back();
+                const EscapeStep step = stepEscape(child_agent, parent_agent, neighbour_node, frame, allAgents);
+                visited[level][neighbour_node->id] = generation;
+                if (step == EscapeStep::COLLISION && Shape::ESCAPE_ANY_NEIGHBOUR)
                     continue;
-                }
+                if (step != EscapeStep::MOVED)
+                    break;
 
-                if (inheritanceConflict(child_agent, allAgents)){
-                    std::map<Agent*, PathState> new_path_states_before_conflict = solveInheritanceConflict(
-                        child_agent, allAgents
-                    );
-
-                    if (new_path_states_before_conflict.empty())
-                    {
-                        ids_of_visited_nodes.insert(neighbour_node->id);
-                        (child_agent->path).pop_back();
-                        break;
-                    } else {
-                        for (auto const& [agent, path_state] : new_path_states_before_conflict)
-                        {
-                            if (path_states_before_conflict.find(agent) == path_states_before_conflict.end()) {
-                                path_states_before_conflict[agent] = path_state;
-                            }
-                        }
-                    }
-                }
-                
-                for (auto const& [moved_agent, _] : path_states_before_conflict) {
-                    if (
-                        setOfAgentsInConflict.find(moved_agent) == setOfAgentsInConflict.end() &&
-                        moved_agent->id != child_agent->id
-                    ) {
-                        moved_agent->path.push_back(moved_agent->path.back());
-                    }
-                }
-                ids_of_visited_nodes.insert(neighbour_node->id);
                 next_node_found_during_greedy_bfs = true;
                 step_counter++;
                 break;
@@ -470,47 +635,241 @@ std::map<LAPIBT::Agent*, LAPIBT::PathState> LAPIBT::escapeInheritanceConflict(Ag
 
             if (!next_node_found_during_greedy_bfs)
             {
-                for (auto const& [agent, path_state] : path_states_before_conflict)
-                {
-                    (agent->path).resize(path_state.size - 1);
-                    (agent->path).push_back(path_state.last_node_in_path);
-                }
-                path_states_before_conflict.clear();
+                LAPIBT_STAT(stats.rollbacks++);
+                restorePaths(frame);
                 break;
             }
         }
 
         if ((child_agent->path).back()->id == node_to_reach->id)
-            return path_states_before_conflict;
+        {
+            escape_nodes.resize(first_target);
+            return true;
+        }
+    }
+    saved_paths.resize(frame);
+    escape_nodes.resize(first_target);
+    return false;
+}
+
+template <class Shape>
+bool LAPIBT<Shape>::isClearOfConflict(const Agent *child_agent, Node *v) const
+{
+    if (pathDist(child_agent->id, v) == max_timestep + 1)
+        return false;
+    for (auto agent : setOfAgentsInConflict)
+        if (Shape::overlap(v->pos, child_agent->shape, agent->path.back()->pos, agent->shape))
+            return false;
+    return true;
+}
+
+template <class Shape>
+bool LAPIBT<Shape>::findEscapeRoute(Agent *child_agent, Agent *parent_agent, int level, unsigned generation, int max_steps)
+{
+    if (escape_seen.empty()) {
+        escape_pred.resize(G->getNodesSize());
+        escape_depth.resize(G->getNodesSize());
+        escape_seen.resize(G->getNodesSize(), 0);
+    }
+    if (++escape_search_generation == 0) {
+        std::fill(escape_seen.begin(), escape_seen.end(), 0);
+        escape_search_generation = 1;
+    }
+
+    const int start = (child_agent->path).back()->id;
+    escape_queue.clear();
+    escape_queue.push_back(start);
+    escape_seen[start] = escape_search_generation;
+    escape_depth[start] = 0;
+
+    // a node closer to the goal of the parent is on its way, the child would be pushed again
+    Node *parent_node = parent_agent->path.back();
+    const int parent_dist = pathDist(parent_agent->id, parent_node);
+    int ahead = NIL; // nearest clear node on the way of the parent
+    int target = NIL;
+
+    for (size_t head = 0; head < escape_queue.size() && target == NIL; ++head)
+    {
+        const int u = escape_queue[head];
+        if (u != start && isClearOfConflict(child_agent, csr.getNode(u))) {
+            if (pathDist(parent_agent->id, csr.getNode(u)) >= parent_dist)
+                target = u;
+            else if (ahead == NIL)
+                ahead = u;
+        }
+        if (escape_depth[u] == max_steps) continue;
+
+        // from a random neighbour on, so that equally short routes are taken in turn
+        const GridCSR::Neighbors neighbors = csr.getNeighbors(u);
+        const int degree = neighbors.size();
+        const int offset = degree > 1 ? getRandomInt(0, degree - 1, MT) : 0;
+        for (int k = 0; k < degree; ++k) {
+            const int v = neighbors[(k + offset) % degree];
+            if (
+                escape_seen[v] == escape_search_generation ||
+                visited[level][v] == generation ||
+                !fits(child_agent->id, v))
+                continue;
+            // while overlapping the parent, only away from it, not through it
+            if (
+                Shape::overlap(Pos(csr.getX(v), csr.getY(v)), child_agent->shape, parent_node->pos, parent_agent->shape) &&
+                csr.euclideanDist(v, parent_node->id) < csr.euclideanDist(u, parent_node->id))
+                continue;
+            escape_seen[v] = escape_search_generation;
+            escape_pred[v] = u;
+            escape_depth[v] = escape_depth[u] + 1;
+            escape_queue.push_back(v);
+        }
     }
-    return {};
+
+    if (target == NIL) target = ahead;
+    if (target == NIL) return false;
+    const size_t first = escape_nodes.size();
+    for (int u = target; u != start; u = escape_pred[u]) escape_nodes.push_back(csr.getNode(u));
+    std::reverse(escape_nodes.begin() + first, escape_nodes.end());
+    return true;
 }
 
-Nodes LAPIBT::getNodesToAvoidInheritanceConflict(const Agent *child_agent, const Agent *parent_agent)
+template <class Shape>
+bool LAPIBT<Shape>::escapeAlongRoute(Agent *child_agent, Agent *parent_agent, const std::vector<Agent *> &allAgents)
 {
-    int x = ((parent_agent->path).back()->pos).x;
-    int y = ((parent_agent->path).back()->pos).y;
+    const size_t frame = saved_paths.size();
+    const size_t first = escape_nodes.size();
+    const int level = setOfAgentsInConflict.size();
+    const unsigned generation = nextVisitedGeneration(level); // nodes where a step failed
+    const int max_steps_allowed = Shape::escapeStepLimit(child_agent->size, parent_agent->size);
+
+    saved_paths.push_back({
+        child_agent,
+        (child_agent->path).size(),
+        (child_agent->path).back()
+    });
+    int step_counter = 0;
+
+    for (int search = 0; search < MAX_ESCAPE_SEARCHES; ++search)
+    {
+        // again from where the last route got stuck
+        escape_nodes.resize(first);
+        if (!findEscapeRoute(child_agent, parent_agent, level, generation, max_steps_allowed - step_counter))
+            break;
+        LAPIBT_STAT(stats.escape_targets_tried++);
+
+        // by index, nested escapes grow escape_nodes
+        const size_t end = escape_nodes.size();
+        size_t k = first;
+        for (; k < end && !overTimestepBudget(); ++k)
+        {
+            Node *v = escape_nodes[k];
+            if (stepEscape(child_agent, parent_agent, v, frame, allAgents) != EscapeStep::MOVED) {
+                visited[level][v->id] = generation;
+                break;
+            }
+            step_counter++;
+        }
+
+        if (k == end)
+        {
+            escape_nodes.resize(first);
+            return true;
+        }
+        if (overTimestepBudget())
+            break;
+    }
 
-    int parent_agent_size = ceil(parent_agent->size);
-    int child_agent_size = ceil(child_agent->size);
+    LAPIBT_STAT(stats.rollbacks++);
+    restorePaths(frame);
+    escape_nodes.resize(first);
+    return false;
+}
 
-    Nodes border;
+template <class Shape>
+unsigned LAPIBT<Shape>::nextVisitedGeneration(int level)
+{
+    if ((int)visited.size() <= level) visited.resize(level + 1);
+    if (visited[level].empty()) visited[level].resize(G->getNodesSize(), 0);
+    if (++visited_generation == 0) {
+        // wrapped around, stamps of old generations would look current
+        for (auto &stamps : visited) std::fill(stamps.begin(), stamps.end(), 0);
+        visited_generation = 1;
+    }
+    return visited_generation;
+}
 
-    int deltaIncrement = std::max(1, int(std::floor((parent_agent_size+child_agent_size)/4)));
+template <class Shape>
+void LAPIBT<Shape>::restorePaths(size_t frame)
+{
+    for (size_t k = frame; k < saved_paths.size(); ++k)
+    {
+        auto &[agent, size, last_node_in_path] = saved_paths[k];
+        (agent->path).resize(size - 1);
+        (agent->path).push_back(last_node_in_path);
+        pathChanged(agent);
+    }
+    saved_paths.resize(frame);
+}
 
-    for (int delta = 0; delta < parent_agent_size + child_agent_size; delta += deltaIncrement) {
-        if (G->existNode(x + delta, y - child_agent_size))
-            border.push_back(G->getNode(x + delta, y - child_agent_size));
+template <class Shape>
+bool LAPIBT<Shape>::isSaved(size_t frame, size_t end, const Agent *agent) const
+{
+    for (size_t k = frame; k < end; ++k)
+        if (saved_paths[k].agent == agent) return true;
+    return false;
+}
 
-        if (G->existNode(x + delta, y + parent_agent_size))
-            border.push_back(G->getNode(x + delta, y + parent_agent_size));
+template <class Shape>
+void LAPIBT<Shape>::mergePaths(size_t frame, size_t from)
+{
+    // the state saved first is the one before the conflict
+    size_t end = from;
+    for (size_t k = from; k < saved_paths.size(); ++k)
+        if (!isSaved(frame, from, saved_paths[k].agent)) saved_paths[end++] = saved_paths[k];
+    saved_paths.resize(end);
+}
 
-        if (G->existNode(x - child_agent_size, y + delta))
-            border.push_back(G->getNode(x - child_agent_size, y + delta));
+template <class Shape>
+bool LAPIBT<Shape>::overTimestepBudget() const
+{
+    return timestep_budget > 0 && Time::now() > timestep_deadline;
+}
 
-        if (G->existNode(x + parent_agent_size, y + delta))
-            border.push_back(G->getNode(x + parent_agent_size, y + delta));
+template <class Shape>
+void LAPIBT<Shape>::makeLogBasicInfo(std::ostream &log)
+{
+    LargeAgentsMAPFSolver::makeLogBasicInfo(log);
+    log << "timestep_budget=" << timestep_budget << "\n";
+    log << "conflict_backend=" << getConflictBackendName(conflict_backend) << "\n";
+    log << "escape_search=" << getEscapeSearchName(escape_search) << "\n";
+    if (timestep_budget > 0) {
+        log << "timestep_budget_overruns="
+            << std::count_if(stats.timestep_times.begin(), stats.timestep_times.end(),
+                             [&](long long t) { return t > 1000LL * timestep_budget; })
+            << "\n";
     }
-    
-    return border;
-}
\ No newline at end of file
+    stats.writeTimestepTimes(log);
+    if (stall_window > 0) {
+        log << "stall_window=" << stall_window << "\n";
+        log << "restarts=" << restart_timesteps.size() << "\n";
+        log << "restart_timesteps=";
+        for (size_t k = 0; k < restart_timesteps.size(); ++k)
+            log << (k ? "," : "") << restart_timesteps[k];
+        log << "\n";
+    }
+    LAPIBT_STAT(stats.write(log));
+}
+
+template <class Shape>
+void LAPIBT<Shape>::makeLogStats(std::ostream &log)
+{
+    LAPIBT_STAT(stats.write(log));
+    stats.writeTimestepTimes(log, true);
+}
+
+template <class Shape>
+void LAPIBT<Shape>::getNodesToAvoidInheritanceConflict(const Agent *child_agent, const Agent *parent_agent, Nodes &nodes)
+{
+    Shape::border(G, parent_agent->path.back(), parent_agent->shape, child_agent->shape, nodes);
+}
+
+template class LAPIBT<SquareShape>;
+template class LAPIBT<CircleShape>;
+template class LAPIBT<MixedShape>;
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <fstream>
+#include <regex>
+
+#include "../include/lifelong.hpp"
+#include "../include/exceptions.hpp"
+
+// attempts to draw a random goal that fits every agent
+static constexpr int MAX_TASK_GENERATION_ATTEMPTS = 1000;
+
+LifelongLargeAgentsMAPF::LifelongLargeAgentsMAPF(LargeAgentsMapfProblem *_P,
+                                                 LargeAgentsMAPFSolver *_solver)
+    : P(_P),
+      solver(_solver),
+      task_num(_P->getTaskNum()),
+      task_frequency(_P->getTaskFrequency()),
+      released_tasks(0),
+      has_task(_P->getNum(), true),
+      previous_goals(_P->getNum(), nullptr),
+      dropped_tasks(_P->getNum()),
+      timestep(0)
+{
+    if (!P->getTaskFile().empty())
+        readTaskFile(P->getTaskFile());
+
+    for (auto &s : P->getAgentShapes()) {
+        auto itr = std::find_if(task_shapes.begin(), task_shapes.end(),
+                                [&](const AgentShape &t) { return t.kind == s.kind; });
+        if (itr == task_shapes.end()) {
+            task_shapes.push_back(s);
+            continue;
+        }
+        itr->w = std::max(itr->w, s.w);
+        itr->h = std::max(itr->h, s.h);
+    }
+}
+
+void LifelongLargeAgentsMAPF::readTaskFile(const std::string &task_file)
+{
+    std::ifstream file(task_file);
+    if (!file) halt("task file " + task_file + " is not found.");
+
+    std::string line;
+    std::smatch results;
+    std::regex r_task = std::regex(R"((\d+),(\d+))");
+    while (getline(file, line)) {
+        if (!line.empty() && *(line.end() - 1) == 0x0d) line.pop_back();
+        if (!std::regex_match(line, results, r_task)) continue;
+        int x = std::stoi(results[1].str());
+        int y = std::stoi(results[2].str());
+        if (!P->getG()->existNode(x, y))
+            halt("task (" + std::to_string(x) + ", " + std::to_string(y) + ") does not exist");
+        task_file_goals.push_back(P->getG()->getNode(x, y));
+    }
+}
+
+void LifelongLargeAgentsMAPF::releaseTasks()
+{
+    // total number of tasks that should be released by now
+    const int due = std::min(task_num, int(timestep * task_frequency));
+    while (released_tasks < due) {
+        Node *g = generateTask();
+        if (g == nullptr) break;
+        open_tasks.push_back(g);
+        ++released_tasks;
+    }
+}
+
+Node *LifelongLargeAgentsMAPF::generateTask()
+{
+    if (!task_file_goals.empty()) {
+        if (released_tasks >= (int)task_file_goals.size()) return nullptr;
+        return task_file_goals[released_tasks];
+    }
+
+    Graph *G = P->getG();
+    for (int attempt = 0; attempt < MAX_TASK_GENERATION_ATTEMPTS; ++attempt) {
+        Node *g = G->getNode(getRandomInt(0, G->getNodesSize() - 1, P->getMT()));
+        if (g != nullptr && std::all_of(task_shapes.begin(), task_shapes.end(),
+                                        [&](const AgentShape &s) {
+                                            return P->fits(g->pos.x, g->pos.y, s);
+                                        }))
+            return g;
+    }
+    return nullptr;
+}
+
+bool LifelongLargeAgentsMAPF::assignTask(int i, Node *g)
+{
+    const AgentShape &shape = P->getAgentShape(i);
+    Config goals = P->getConfigGoal();
+    if (!P->fits(g->pos.x, g->pos.y, shape) ||
+        P->isInCollision(&goals, g->pos.x, g->pos.y, shape, i))
+        return false;
+
+    if (!solver->isReachable(i, solver->getSolution().last(i), g)) return false;
+
+    previous_goals[i] = P->getGoal(i);
+    solver->updateGoal(i, g);
+    return true;
+}
+
+void LifelongLargeAgentsMAPF::solve()
+{
+    if (!solver->initialize()) return;
+
+    while (timestep < solver->getMaxTimestep() &&
+           solver->getSolverElapsedTime() <= P->getMaxCompTime()) {
+        Config c;
+        try {
+            c = solver->step();
+        } catch (too_high_compute_time_exception &e) {
+            break;
+        }
+        ++timestep;
+
+        for (int i = 0; i < P->getNum(); ++i) {
+            if (has_task[i] && c[i] == P->getGoal(i)) {
+                has_task[i] = false;
+                dropped_tasks[i].clear();
+                completion_timesteps.push_back(timestep);
+            }
+        }
+
+        // a task turns out to be beyond max_timestep once the table of its agent is ready
+        for (int i = 0; i < P->getNum(); ++i) {
+            if (!has_task[i] || !solver->isDistanceTableReady(i) ||
+                solver->pathDist(i, c[i]) <= solver->getMaxTimestep())
+                continue;
+            open_tasks.push_front(P->getGoal(i));
+            dropped_tasks[i].push_back(P->getGoal(i));
+            // back to the goal before the task, which does not block the goals of others,
+            // an agent dropping its initial goal stays where it is
+            Config goals = P->getConfigGoal();
+            Node *g = previous_goals[i] != nullptr ? previous_goals[i] : c[i];
+            if (P->isInCollision(&goals, g->pos.x, g->pos.y, P->getAgentShape(i), i)) g = c[i];
+            solver->updateGoal(i, g);
+            has_task[i] = false;
+        }
+
+        releaseTasks();
+
+        for (int i = 0; i < P->getNum() && !open_tasks.empty(); ++i) {
+            if (has_task[i]) continue;
+            for (auto task = open_tasks.begin(); task != open_tasks.end(); ++task) {
+                if (inArray(*task, dropped_tasks[i])) continue;
+                if (assignTask(i, *task)) {
+                    open_tasks.erase(task);
+                    has_task[i] = true;
+                    break;
+                }
+            }
+        }
+        // the tasks assigned next have their tables ready by then
+        solver->prefetchDistanceTables(open_tasks);
+
+        if (succeed()) break;
+    }
+
+    solver->finalize();
+}
+
+bool LifelongLargeAgentsMAPF::succeed() const
+{
+    return getTasksCompleted() == P->getNum() + task_num;
+}
+
+double LifelongLargeAgentsMAPF::getThroughput() const
+{
+    return timestep > 0 ? double(getTasksCompleted()) / timestep : 0;
+}
+
+void LifelongLargeAgentsMAPF::printResult() const
+{
+    std::cout << "tasks_completed=" << getTasksCompleted() << "/" << P->getNum() + task_num
+              << ", timesteps=" << timestep << ", throughput=" << getThroughput()
+              << ", comp_time(ms)=" << solver->getSolverElapsedTime() << std::endl;
+}
+
+void LifelongLargeAgentsMAPF::makeLog(const std::string &logfile)
+{
+    solver->makeLog(logfile);
+
+    std::ofstream log;
+    log.open(logfile, std::ios::app);
+    log << "lifelong=1\n";
+    log << "task_num=" << task_num << "\n";
+    log << "task_frequency=" << task_frequency << "\n";
+    log << "tasks_released=" << P->getNum() + released_tasks << "\n";
+    log << "tasks_completed=" << getTasksCompleted() << "\n";
+    log << "timesteps=" << timestep << "\n";
+    log << "throughput=" << getThroughput() << "\n";
+    log << "task_completion_timesteps=";
+    for (size_t k = 0; k < completion_timesteps.size(); ++k)
+        log << (k ? "," : "") << completion_timesteps[k];
+    log << "\n";
+    log.close();
+}
+
+void LifelongLargeAgentsMAPF::halt(const std::string &msg) const
+{
+    std::cout << "error@Lifelong: " << msg << std::endl;
+    std::exit(1);
+}
@@ -2,11 +2,13 @@
 #include <iostream>
 #include <fstream>
 #include <regex>
+#include <sstream>
 #include <queue>
 #include <unordered_set>
 
 #include "../include/mapf_problem.hpp"
 #include "../include/graph_utils.hpp"
+#include "../include/exceptions.hpp"
 
 MapfProblem::MapfProblem(std::string _instance, Graph *_G, std::mt19937 *_MT,
                  Config _config_s, Config _config_g, int _num_agents,
@@ -31,7 +33,13 @@ Node *MapfProblem::getGoal(int i) const {
     return config_g[i];
 }
 
+void MapfProblem::setGoal(int i, Node *g) {
+    if (!(0 <= i && i < (int) config_g.size())) halt("invalid index");
+    config_g[i] = g;
+}
+
 void MapfProblem::halt(const std::string &msg) const {
+    if (halt_throws) throw invalid_instance_exception(msg);
     std::cout << "error@Problem: " << msg << std::endl;
     this->~MapfProblem();
     std::exit(1);
@@ -49,12 +57,29 @@ LargeAgentsMapfProblem::LargeAgentsMapfProblem(const std::string& _instance, con
 {
     MT = new std::mt19937(seed);
     readInstanceFile(_instance);
+    csr = std::make_shared<GridCSR>(G);
 }
 
 LargeAgentsMapfProblem::LargeAgentsMapfProblem(const std::string& _instance)
     : MapfProblem(_instance), instance_initialized(true), sizes(std::vector<float>(0))
 {
     readInstanceFile(_instance);
+    csr = std::make_shared<GridCSR>(G);
+}
+
+LargeAgentsMapfProblem::LargeAgentsMapfProblem(const std::string& _instance, GridStore *_grid_store)
+    : MapfProblem(_instance), instance_initialized(true), grid_store(_grid_store),
+      sizes(std::vector<float>(0))
+{
+    // an invalid instance must not stop the process of the other instances
+    halt_throws = true;
+    try {
+        readInstanceFile(_instance);
+    } catch (invalid_instance_exception &e) {
+        delete MT;
+        throw;
+    }
+    csr = std::make_shared<GridCSR>(G);
 }
 
 std::vector<float> LargeAgentsMapfProblem::getMinMaxRadiuses() {
@@ -93,20 +118,37 @@ void LargeAgentsMapfProblem::readInstanceFile(const std::string &_instance) {
     std::regex r_map = std::regex(R"(map_file=(.+))");
     std::regex r_agents = std::regex(R"(agents=(\d+))");
     std::regex r_well_formed = std::regex(R"(well_formed=(\d+))");
-    std::regex r_sizes = std::regex("sizes=(\\(?(\\d*[.]?\\d*,? ?)*\\)?)");
+    std::regex r_sizes = std::regex("sizes=(\\(?(\\d*[.]?\\d*(x\\d*[.]?\\d*)?,? ?)*\\)?)");
     std::regex r_sizes_random_uniform = std::regex(R"(sizes_random_uniform=(\d*[.]?\d*),(\d*[.]?\d*))");
     std::regex r_seed = std::regex(R"(seed=(\d+))");
     std::regex r_random_problem = std::regex(R"(random_problem=(\d+))");
     std::regex r_max_timestep = std::regex(R"(max_timestep=(\d+))");
     std::regex r_max_comp_time = std::regex(R"(max_comp_time=(\d+))");
     std::regex r_sg = std::regex(R"((\d+),(\d+),(\d+),(\d+))");
+    std::regex r_task_num = std::regex(R"(task_num=(\d+))");
+    std::regex r_task_frequency = std::regex(R"(task_frequency=(\d*[.]?\d*))");
+    std::regex r_task_file = std::regex(R"(task_file=(.+))");
+    std::regex r_shape = std::regex(R"(shape=(\w+))");
+    std::regex r_shapes = std::regex(R"(shapes=(\w+(, ?\w+)*))");
 
     bool read_scen = true;
     bool well_formed = false;
     bool radius_done = false;
 
+    // shapes are made from the keys above the starts/goals
+    ShapeKind default_kind = ShapeKind::SQUARE;  // shape=
+    std::vector<ShapeKind> kinds;                // shapes=, per agent
+    std::vector<float> heights;                  // of sizes=wxh, -1 if not given
+    auto makeShapes = [&]() {
+        if (!shapes.empty()) return;
+        if (!makeAgentShapes(sizes, heights, default_kind, kinds, shapes))
+            halt("sizes given as wxh have to be of rect agents");
+        for (size_t i = 0; i < shapes.size(); ++i) sizes[i] = shapes[i].getSize();
+        shape = getShapeKind(shapes);
+    };
+
     while (getline(file, line)) {
-        if (*(line.end() - 1) == 0x0d) line.pop_back();
+        if (!line.empty() && *(line.end() - 1) == 0x0d) line.pop_back();
 
         // comment
         if (std::regex_match(line, results, r_comment)) {
@@ -114,7 +156,12 @@ void LargeAgentsMapfProblem::readInstanceFile(const std::string &_instance) {
         }
         // read map
         if (std::regex_match(line, results, r_map)) {
-            G = new Grid(results[1].str());
+            if (grid_store == nullptr) {
+                G = new Grid(results[1].str());
+            } else {
+                G = grid_store->get(results[1].str());
+                if (G == nullptr) halt("map " + results[1].str() + " is not found or invalid.");
+            }
             continue;
         }
         // set agent num
@@ -147,13 +194,13 @@ void LargeAgentsMapfProblem::readInstanceFile(const std::string &_instance) {
             result.erase(end_pos_rbr, result.end());
 
             std::string token;
-            std::size_t pos = 0;
-            while ((pos = result.find(",")) != std::string::npos) {
-                token = result.substr(0, pos);
-                sizes.push_back(std::stof(token));
-                result.erase(0, pos + 1);
+            std::stringstream tokens(result);
+            while (std::getline(tokens, token, ',')) {
+                float w, h;
+                parseSize(token, w, h);  // rectangles as wxh
+                sizes.push_back(w);
+                heights.push_back(h);
             }
-            sizes.push_back(std::stof(result));
 
             // check sizes initialized
             if (sizes.size() < num_agents) {
@@ -198,23 +245,54 @@ void LargeAgentsMapfProblem::readInstanceFile(const std::string &_instance) {
             max_comp_time = std::stoi(results[1].str());
             continue;
         }
+        // lifelong tasks
+        if (std::regex_match(line, results, r_task_num)) {
+            task_num = std::stoi(results[1].str());
+            continue;
+        }
+        if (std::regex_match(line, results, r_task_frequency)) {
+            task_frequency = std::stof(results[1].str());
+            continue;
+        }
+        if (std::regex_match(line, results, r_task_file)) {
+            task_file = results[1].str();
+            continue;
+        }
+        // agent shape, square by default
+        if (std::regex_match(line, results, r_shape)) {
+            if (!parseShape(results[1].str(), default_kind)) halt("unknown shape " + results[1].str());
+            continue;
+        }
+        // shape of every agent, overrides shape=
+        if (std::regex_match(line, results, r_shapes)) {
+            std::string name;
+            std::stringstream names(results[1].str());
+            while (std::getline(names, name, ',')) {
+                name.erase(std::remove(name.begin(), name.end(), ' '), name.end());
+                kinds.emplace_back();
+                if (!parseShape(name, kinds.back())) halt("unknown shape " + name);
+            }
+            continue;
+        }
         // read initial/goal nodes
         if (std::regex_match(line, results, r_sg) && read_scen &&
             (int) config_s.size() < (int) sizes.size() && (int) config_g.size() < (int) sizes.size() &&
             (int) config_s.size() < num_agents) {
+            if (G == nullptr) halt("map_file has to come before the start - end positions");
+            makeShapes();
             int x_s = std::stoi(results[1].str());
             int y_s = std::stoi(results[2].str());
             int x_g = std::stoi(results[3].str());
             int y_g = std::stoi(results[4].str());
-            if (!(checkIfNodeExistInRadiusOnGrid(G, x_s, y_s, sizes[config_s.size()]))) {
+            if (!fits(x_s, y_s, shapes[config_s.size()])) {
                 halt("start node (" + std::to_string(x_s) + ", " + std::to_string(y_s) +
                      ") does not exist, or there are object in its radius " +
-                     std::to_string(sizes[config_s.size()]) + ", invalid scenario");
+                     getSizeName(shapes[config_s.size()]) + ", invalid scenario");
             }
-            if (!checkIfNodeExistInRadiusOnGrid(G, x_g, y_g, sizes[config_g.size()])) {
+            if (!fits(x_g, y_g, shapes[config_g.size()])) {
                 halt("goal node (" + std::to_string(x_g) + ", " + std::to_string(y_g) +
                      ") does not exist, or there are object in its radius " +
-                     std::to_string(sizes[config_g.size()]) + ", invalid scenario");
+                     getSizeName(shapes[config_g.size()]) + ", invalid scenario");
             }
 
             Node *s = G->getNode(x_s, y_s);
@@ -230,12 +308,15 @@ void LargeAgentsMapfProblem::readInstanceFile(const std::string &_instance) {
         }
     }
 
+    makeShapes();
+
     // set default value not identified params
     if (MT == nullptr) MT = new std::mt19937(DEFAULT_SEED);
     if (max_timestep == 0) max_timestep = DEFAULT_MAX_TIMESTEP;
     if (max_comp_time == 0) max_comp_time = DEFAULT_MAX_COMP_TIME;
 
     // check starts/goals
+    if (G == nullptr) halt("map_file is not set");
     if (num_agents <= 0) halt("invalid number of agents");
 
 
@@ -263,7 +344,10 @@ LargeAgentsMapfProblem::LargeAgentsMapfProblem(LargeAgentsMapfProblem *P, Config
         : MapfProblem(P->getInstanceFileName(), P->getG(), P->getMT(), _config_s,
                   _config_g, P->getNum(), _max_timestep, _max_comp_time),
           instance_initialized(false),
-          sizes(*_sizes) {
+          sizes(*_sizes),
+          shapes(P->getAgentShapes()),
+          shape(P->getShape()),
+          csr(P->csr) {
 }
 
 LargeAgentsMapfProblem::LargeAgentsMapfProblem(LargeAgentsMapfProblem *P, int _max_comp_time)
@@ -271,37 +355,46 @@ LargeAgentsMapfProblem::LargeAgentsMapfProblem(LargeAgentsMapfProblem *P, int _m
                   P->getConfigStart(), P->getConfigGoal(), P->getNum(),
                   P->getMaxTimestep(), _max_comp_time),
           instance_initialized(false),
-          sizes(P->getSizes()) {
+          sizes(P->getSizes()),
+          shapes(P->getAgentShapes()),
+          shape(P->getShape()),
+          csr(P->csr) {
+}
+
+LargeAgentsMapfProblem::LargeAgentsMapfProblem(const std::string &_instance, Graph *_G,
+                                               std::mt19937 *_MT, Config _config_s,
+                                               Config _config_g, AgentShapes _shapes,
+                                               int _max_timestep, int _max_comp_time)
+        : MapfProblem(_instance, _G, _MT, _config_s, _config_g, _config_s.size(),
+                      _max_timestep, _max_comp_time),
+          instance_initialized(false),
+          shapes(_shapes),
+          shape(getShapeKind(_shapes)) {
+    for (auto &s : shapes) sizes.push_back(s.getSize());
+    csr = std::make_shared<GridCSR>(G);
 }
 
 LargeAgentsMapfProblem::~LargeAgentsMapfProblem() {
     if (instance_initialized) {
-        if (G != nullptr) delete G;
+        if (G != nullptr && grid_store == nullptr) delete G;
         if (MT != nullptr) delete MT;
     }
 }
 
-bool LargeAgentsMapfProblem::isInCollision(Config *C, int id, float s) {
-    Grid *grid = reinterpret_cast<Grid *>(G);
-    int y = std::ceil(id / grid->getHeight());
-    int x = (id - y);
-    return isInCollision(C, x, y, s);
+bool LargeAgentsMapfProblem::fits(int x, int y, const AgentShape &s) const {
+    return fitsShape(G, x, y, s);
 }
 
-bool LargeAgentsMapfProblem::isInCollision(Config *C, int x, int y, float s) {
-    for (int i = 0; i < (*C).size(); i++) {
-        int i_pos_x = (*C)[i]->pos.x;
-        int i_pos_y = (*C)[i]->pos.y;
-        float i_size = ceil(sizes[i]);
-
-        if (
-                x > i_pos_x - s &&
-                x < i_pos_x + i_size &&
-                y > i_pos_y - s &&
-                y < i_pos_y + i_size
-            ) return true;
-    }
-    return false;
+bool LargeAgentsMapfProblem::isInCollision(Config *C, int x, int y, const AgentShape &s,
+                                           int ignored_agent) {
+    return withShape(shape, [&](auto S) {
+        const Pos p(x, y);
+        for (size_t i = 0; i < (*C).size(); i++) {
+            if (int(i) == ignored_agent) continue;
+            if (decltype(S)::overlap(p, s, (*C)[i]->pos, shapes[i])) return true;
+        }
+        return false;
+    });
 }
 
 void LargeAgentsMapfProblem::setRandomStartsGoals() {
@@ -312,7 +405,7 @@ void LargeAgentsMapfProblem::setRandomStartsGoals() {
 
 void LargeAgentsMapfProblem::setRandomStarts() {
     config_s.clear();
-    Grid *grid = reinterpret_cast<Grid *>(G);
+    Grid *grid = getGrid();
     const int N = grid->getWidth() * grid->getHeight();
 
     std::vector<int> starts(N);
@@ -327,15 +420,15 @@ void LargeAgentsMapfProblem::setRandomStarts() {
             y = int(starts[i] / grid->getWidth());
             ++i;
             if (i >= N) halt("number of agents is too large.");
-        } while (!checkIfNodeExistInRadiusOnGrid(G, x, y, sizes[config_s.size()]) ||
-                 isInCollision(&config_s, x, y, sizes[config_s.size()]));
+        } while (!fits(x, y, shapes[config_s.size()]) ||
+                 isInCollision(&config_s, x, y, shapes[config_s.size()]));
         config_s.push_back(G->getNode(starts[i - 1]));
     }
 }
 
 void LargeAgentsMapfProblem::setRandomGoals() {
     config_g.clear();
-    Grid *grid = reinterpret_cast<Grid *>(G);
+    Grid *grid = getGrid();
     const int N = grid->getWidth() * grid->getHeight();
 
     std::vector<int> goals(N);
@@ -350,8 +443,8 @@ void LargeAgentsMapfProblem::setRandomGoals() {
             x = goals[i] % grid->getWidth();
             y = int(goals[i] / grid->getWidth());
             ++i;
-        } while (!checkIfNodeExistInRadiusOnGrid(G, x, y, sizes[config_g.size()]) ||
-                 isInCollision(&config_g, x, y, sizes[config_g.size()]));
+        } while (!fits(x, y, shapes[config_g.size()]) ||
+                 isInCollision(&config_g, x, y, shapes[config_g.size()]));
         config_g.push_back(G->getNode(goals[i - 1]));
     }
 }
@@ -370,7 +463,7 @@ void LargeAgentsMapfProblem::setWellFormedStarts() {
 };
 
 void LargeAgentsMapfProblem::setWellFormedGoals() {
-    Grid *grid = reinterpret_cast<Grid *>(G);
+    Grid *grid = getGrid();
     const int N = grid->getWidth() * grid->getHeight();
 
     while ((int) config_g.size() != num_agents) {
@@ -380,7 +473,7 @@ void LargeAgentsMapfProblem::setWellFormedGoals() {
         /// BFS to find accessible nodes;
         std::queue<Node*> OPEN;
         Node* n = start;
-        float r = sizes[config_g.size()];
+        const AgentShape &r = shapes[config_g.size()];
 
         OPEN.push(n);
         while (!OPEN.empty()) {
@@ -392,7 +485,7 @@ void LargeAgentsMapfProblem::setWellFormedGoals() {
 
                 int x = m->id % grid->getWidth();
                 int y = std::floor( m->id / grid->getWidth());
-                if (checkIfNodeExistInRadiusOnGrid(G, x, y, r)) {
+                if (fits(x, y, r)) {
                     reachable_nodes.insert(m);
                     OPEN.push(m);
                 }
@@ -413,7 +506,7 @@ void LargeAgentsMapfProblem::setWellFormedGoals() {
             y = int(goals[j] / grid->getWidth());
             ++j;
         } while (!reachable_nodes.count(G->getNode(goals[j - 1])) ||
-                 isInCollision(&config_g, x, y, sizes[config_g.size()]));
+                 isInCollision(&config_g, x, y, shapes[config_g.size()]));
 
         config_g.push_back(G->getNode(goals[j - 1]));
     }
@@ -424,16 +517,23 @@ void LargeAgentsMapfProblem::setWellFormedGoals() {
  */
 
 void LargeAgentsMapfProblem::makeScenFile(const std::string &output_file) {
-    Grid *grid = reinterpret_cast<Grid *>(G);
+    Grid *grid = getGrid();
     std::ofstream log;
     log.open(output_file, std::ios::out);
     log << "map_file=" << grid->getMapFileName() << "\n";
     log << "agents=" << num_agents << "\n";
-    log << "sizes=" << sizes[0];
-    for (int it = 1; it < sizes.size(); it++) {
-        log << ", " << sizes[it];
+    log << "sizes=" << getSizeName(shapes[0]);
+    for (size_t it = 1; it < shapes.size(); it++) {
+        log << ", " << getSizeName(shapes[it]);
     }
     log << "\n";
+    if (shape != ShapeKind::MIXED) {
+        log << "shape=" << getShapeName(shape) << "\n";
+    } else {
+        log << "shapes=" << getShapeName(shapes[0].kind);
+        for (size_t it = 1; it < shapes.size(); it++) log << "," << getShapeName(shapes[it].kind);
+        log << "\n";
+    }
     log << "seed=0\n";
     log << "random_problem=0\n";
     log << "max_timestep=" << max_timestep << "\n";
@@ -3,6 +3,7 @@
 #include <iomanip>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 #include "../include/graph_utils.hpp"
 #include "../include/lapibt.hpp"
@@ -72,19 +73,129 @@ void MinimumSolver::printHelpWithoutOption(const std::string& solver_name)
             << "  (no option)" << std::endl;
 }
 
+// -------------------------------
+// utilities for computing path
+// -------------------------------
+MinimumSolver::CompareAstarNode MinimumSolver::compareAstarNodeBasic =
+    [](AstarNode* a, AstarNode* b) {
+      if (a->f != b->f) return a->f > b->f;
+      if (a->g != b->g) return a->g < b->g;  // deeper first
+      return false;
+    };
+
+Path MinimumSolver::getPathBySpaceTimeAstar(Node* const s, Node* const g,
+                                            AstarHeuristics& fValue,
+                                            CompareAstarNode& compare,
+                                            CheckAstarFin& checkAstarFin,
+                                            CheckInvalidAstarNode& checkInvalidAstarNode,
+                                            const int time_limit, const int time_horizon)
+{
+  auto t_start = Time::now();
+  auto getKey = [&](Node* v, int t) {
+    return AstarNode::getKey(v, time_horizon >= 0 ? std::min(t, time_horizon) : t);
+  };
+  auto& OPEN = astar_open;
+  auto& CLOSE = astar_closed;
+  OPEN.clear();
+  CLOSE.clear();
+  astar_nodes.clear();
+
+  auto n = astar_nodes.create(s, 0, nullptr);
+  n->f = fValue(n);
+  OPEN.push_back(n);
+
+  AstarNode* goal_node = nullptr;
+  int iteration = 0;
+  while (!OPEN.empty()) {
+    // checking the clock at every expansion would dominate small searches
+    if (time_limit >= 0 && (++iteration & 255) == 0 &&
+        getElapsedTime(t_start) > time_limit)
+      break;
+
+    std::pop_heap(OPEN.begin(), OPEN.end(), compare);
+    n = OPEN.back();
+    OPEN.pop_back();
+    if (!CLOSE.insert(getKey(n->v, n->g)).second) continue;
+
+    if (checkAstarFin(n)) {
+      goal_node = n;
+      break;
+    }
+
+    auto expand = [&](Node* u) {
+      if (CLOSE.count(getKey(u, n->g + 1)) != 0) return;
+      auto m = astar_nodes.create(u, n->g + 1, n);
+      if (checkInvalidAstarNode(m)) return;
+      m->f = fValue(m);
+      OPEN.push_back(m);
+      std::push_heap(OPEN.begin(), OPEN.end(), compare);
+    };
+    for (auto u : n->v->neighbor) expand(u);
+    expand(n->v);
+  }
+
+  Path path;
+  for (n = goal_node; n != nullptr; n = n->p) path.push_back(n->v);
+  std::reverse(path.begin(), path.end());
+  return path;
+}
+
+static const char* ESCAPE_SEARCH_NAMES[] = {"greedy", "bfs"};
+
+bool parseEscapeSearch(const std::string& name, EscapeSearch& search)
+{
+    for (auto s : {EscapeSearch::GREEDY, EscapeSearch::BFS}) {
+        if (name != ESCAPE_SEARCH_NAMES[int(s)]) continue;
+        search = s;
+        return true;
+    }
+    return false;
+}
+
+std::string getEscapeSearchName(EscapeSearch search) { return ESCAPE_SEARCH_NAMES[int(search)]; }
+
 // -----------------------------------------------
 // base class for Free Space Agent
 // -----------------------------------------------
 LargeAgentsMAPFSolver::LargeAgentsMAPFSolver(LargeAgentsMapfProblem* problem)
         : MinimumSolver(problem),
           P(problem),
+          csr(problem->getCSR()),
           LB_soc(0),
           LB_makespan(0),
-          distance_table(problem->getNum(),
-                         std::vector<int>(G->getNodesSize(), max_timestep + 1)),
-          distance_table_p(nullptr) {}
+          distance_table(problem->getNum()),
+          distance_table_p(nullptr),
+          successor_order(problem->getNum()),
+          reservations(problem->getGrid(), problem->getAgentShapes(), problem->getShape()),
+          pending_tables(problem->getNum())
+{
+    for (auto& s : problem->getAgentShapes()) {
+        const AgentShape f = s.footprint();
+        auto itr = std::find(shape_classes.begin(), shape_classes.end(), f);
+        shape_class_of.push_back(itr - shape_classes.begin());
+        if (itr == shape_classes.end()) shape_classes.push_back(f);
+    }
+    clearance_maps.resize(shape_classes.size());
+    distance_bfs.resize(shape_classes.size());
+}
+
+bool LargeAgentsMAPFSolver::fits(int i, int id)
+{
+    auto& clearance = clearance_maps[shape_class_of[i]];
+    if (clearance.empty()) clearance.resize(csr.size(), UNKNOWN);
+    if (clearance[id] == UNKNOWN)
+        clearance[id] = fitsShape(G, csr.getX(id), csr.getY(id), P->getAgentShape(i)) ? CLEAR : BLOCKED;
+    return clearance[id] == CLEAR;
+}
 
 void LargeAgentsMAPFSolver::exec()
+{
+    preprocess();
+    run();
+    if (solved && lns_time_limit > 0) improveSolutionByLNS();
+}
+
+void LargeAgentsMAPFSolver::preprocess()
 {
     // create distance table
     if (distance_table_p == nullptr) {
@@ -93,40 +204,268 @@ void LargeAgentsMAPFSolver::exec()
         preprocessing_comp_time = getSolverElapsedTime();
         info("  done, elapsed: ", preprocessing_comp_time);
     }
+}
 
-    run();
+bool LargeAgentsMAPFSolver::initialize()
+{
+    start();
+    preprocess();
+    return initializeSolver();
 }
 
-void LargeAgentsMAPFSolver::createDistanceTable(){
+Config LargeAgentsMAPFSolver::step()
+{
+    halt("step() is not supported by this solver");
+    return {};
+}
 
-    Grid* grid = reinterpret_cast<Grid*>(G);
+void LargeAgentsMAPFSolver::updateGoal(int i, Node* g)
+{
+    P->setGoal(i, g);
+    if (distance_table_workers && distance_oracle == DistanceOracle::EXACT)
+        requestDistanceTable(i);
+    else
+        createDistanceTable(i);
+    // lower bounds are recomputed for the new goals
+    LB_soc = 0;
+    LB_makespan = 0;
+}
 
-    for (int i = 0; i < P->getNum(); ++i) {
-        std::queue<Node*> OPEN;
-        Node* n = P->getGoal(i);
-        float r = P->getSize(i);
-        OPEN.push(n);
-        distance_table[i][n->id] = 0;
-        while (!OPEN.empty()) {
-
-            n = OPEN.front();
-            OPEN.pop();
-            const int d_n = distance_table[i][n->id];
-            for (auto m : n->neighbor) {
-                int x = m->id % grid->getWidth();
-                int y = std::floor( m->id / grid->getWidth());
-                if (checkIfNodeExistInRadiusOnGrid(G, x, y, r)) {
-                    const int d_m = distance_table[i][m->id];
-
-                    if (d_n + 1 >= d_m) continue;
-                    distance_table[i][m->id] = d_n + 1;
-                    OPEN.push(m);
-                }
-            }
+void LargeAgentsMAPFSolver::createDistanceTable()
+{
+    if (distance_table_cache != nullptr || distance_oracle == DistanceOracle::HIERARCHICAL) {
+        // one by one, cached tables are mostly hits
+        for (int i = 0; i < P->getNum(); ++i) createDistanceTable(i);
+    } else {
+        // agents of a shape class search the same open cells, in batches of nearby goals
+        std::vector<std::vector<int>> agents_of_class(shape_classes.size());
+        for (int i = 0; i < P->getNum(); ++i) agents_of_class[shape_class_of[i]].push_back(i);
+        for (auto& agents : agents_of_class) {
+            std::stable_sort(agents.begin(), agents.end(), [&](int i, int j) {
+                return P->getGoal(i)->id < P->getGoal(j)->id;
+            });
+            for (size_t k = 0; k < agents.size(); k += GridBFS::MAX_BATCH)
+                createDistanceTables(&agents[k], std::min<int>(GridBFS::MAX_BATCH, agents.size() - k));
         }
     }
 
     distance_table_p = &distance_table;
+    successor_order_p = &successor_order;
+}
+
+void LargeAgentsMAPFSolver::createDistanceTable(int i)
+{
+    TraceSpan span(trace, "bfs", "preprocessing", "agent", i);
+    pending_tables[i].reset();
+    if (distance_oracle == DistanceOracle::HIERARCHICAL) {
+        if (hierarchical_oracle == nullptr)
+            hierarchical_oracle = std::make_unique<HierarchicalDistanceOracle>(
+                P->getGrid(), csr, P->getNum(), shape_classes.size(), max_timestep + 1);
+        hierarchical_oracle->setGoal(i, shape_class_of[i], *getDistanceBFS(i), P->getGoal(i)->id);
+        hierarchical_oracle_p = hierarchical_oracle.get();
+        return;
+    }
+    lookupDistanceTable(distance_table_cache, *getDistanceBFS(i), P->getGrid(), P->getGoal(i),
+                        P->getAgentShape(i), max_timestep, distance_table[i]);
+    createSuccessorOrder(i);
+}
+
+void LargeAgentsMAPFSolver::createDistanceTables(const int* agents, int count)
+{
+    if (count == 1) {
+        createDistanceTable(agents[0]);
+        return;
+    }
+    TraceSpan span(trace, "bfs_batch", "preprocessing", "agents", count);
+    int goals[GridBFS::MAX_BATCH];
+    std::vector<int>* tables[GridBFS::MAX_BATCH];
+    for (int k = 0; k < count; ++k) {
+        pending_tables[agents[k]].reset();
+        goals[k] = P->getGoal(agents[k])->id;
+        tables[k] = &distance_table[agents[k]];
+    }
+    getDistanceBFS(agents[0])->runBatch(goals, count, max_timestep + 1, tables);
+    for (int k = 0; k < count; ++k) createSuccessorOrder(agents[k]);
+}
+
+void LargeAgentsMAPFSolver::createSuccessorOrder(int i)
+{
+    const std::vector<int>& table = distance_table[i];
+    auto& order = successor_order[i];
+    order.assign(csr.size(), 0);
+    for (int id = 0; id < csr.size(); ++id) {
+        const GridCSR::Neighbors neighbor = csr.getNeighbors(id);
+        if (neighbor.size() > 4) halt("a node has more than 4 neighbours");
+        // insertion sort, stable
+        int k[4];
+        for (int a = 0; a < neighbor.size(); ++a) {
+            int b = a;
+            for (; b > 0 && table[neighbor[k[b - 1]]] > table[neighbor[a]]; --b)
+                k[b] = k[b - 1];
+            k[b] = a;
+        }
+        for (int a = 0; a < neighbor.size(); ++a) order[id] |= k[a] << (2 * a);
+    }
+}
+
+LargeAgentsMAPFSolver::Successors LargeAgentsMAPFSolver::getSuccessors(int i, Node* v) const
+{
+    Successors successors;
+    const GridCSR::Neighbors neighbor = csr.getNeighbors(v->id);
+    successors.size = neighbor.size();
+    const SuccessorOrder& orders = successor_order_p != nullptr ? *successor_order_p : successor_order;
+    if (pending_tables[i] == nullptr && !orders[i].empty()) {
+        const uint8_t order = orders[i][v->id];
+        for (int a = 0; a < successors.size; ++a)
+            successors.nodes[a] = csr.getNode(neighbor[(order >> (2 * a)) & 3]);
+        return successors;
+    }
+    // by pathDist(), e.g. the Manhattan distance of a pending table, insertion sort, stable
+    for (int a = 0; a < successors.size; ++a) {
+        Node* u = csr.getNode(neighbor[a]);
+        const int d = pathDist(i, u);
+        int b = a;
+        for (; b > 0 && pathDist(i, successors.nodes[b - 1]) > d; --b)
+            successors.nodes[b] = successors.nodes[b - 1];
+        successors.nodes[b] = u;
+    }
+    return successors;
+}
+
+std::shared_ptr<const GridBFS> LargeAgentsMAPFSolver::getDistanceBFS(int i)
+{
+    auto& bfs = distance_bfs[shape_class_of[i]];
+    if (bfs == nullptr)
+        bfs = std::make_shared<GridBFS>(P->getGrid(), csr, P->getAgentShape(i));
+    return bfs;
+}
+
+bool LargeAgentsMAPFSolver::isReachable(int i, Node *v, Node *g)
+{
+    if (!getDistanceBFS(i)->isConnected(v->id, g->id)) return false;
+    for (auto& prefetched : prefetched_tables) {
+        if (prefetched->goal != g ||
+            prefetched->done.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            continue;
+        return (*prefetched->tables[shape_class_of[i]])[v->id] <= max_timestep;
+    }
+    return true;
+}
+
+void LargeAgentsMAPFSolver::lookupDistanceTable(DistanceTableCache* cache, const GridBFS& bfs,
+                                                Grid* grid, Node* goal, const AgentShape& shape,
+                                                int max_timestep, std::vector<int>& table)
+{
+    if (cache == nullptr) {
+        computeDistanceTable(bfs, goal, max_timestep, table);
+        return;
+    }
+    DistanceTableCache::Key key{grid->getMapFileName(), goal->id, shape.footprint(), max_timestep};
+    cache->get(key, table, [&](std::vector<int>& t) {
+        computeDistanceTable(bfs, goal, max_timestep, t);
+    });
+}
+
+void LargeAgentsMAPFSolver::computeDistanceTable(const GridBFS& bfs, Node* goal, int max_timestep,
+                                                 std::vector<int>& table)
+{
+    bfs.run(goal->id, max_timestep + 1, table);
+}
+
+void LargeAgentsMAPFSolver::shareDistanceTable(LargeAgentsMAPFSolver* other)
+{
+    distance_table_p = other->distance_table_p;
+    successor_order_p = other->successor_order_p;
+    hierarchical_oracle_p = other->hierarchical_oracle_p;
+    preprocessing_comp_time = 0;
+}
+
+void LargeAgentsMAPFSolver::setDistanceTableWorkers(int num_threads)
+{
+    distance_table_workers = std::make_unique<ThreadPool>(num_threads);
+}
+
+void LargeAgentsMAPFSolver::requestDistanceTable(int i)
+{
+    // a table still computed for a previous goal is dropped, its worker holds the buffer
+    auto pending = std::make_unique<PendingDistanceTable>();
+    Node* goal = P->getGoal(i);
+    auto prefetched = std::find_if(prefetched_tables.begin(), prefetched_tables.end(),
+                                   [&](auto& p) { return p->goal == goal; });
+    if (prefetched != prefetched_tables.end()) {
+        pending->table = (*prefetched)->tables[shape_class_of[i]];
+        pending->done = std::move((*prefetched)->done);
+        prefetched_tables.erase(prefetched);
+        ++prefetched_distance_tables;
+    } else {
+        pending->table = std::make_shared<std::vector<int>>();
+        auto table = pending->table;
+        Grid* grid = P->getGrid();
+        std::shared_ptr<const GridBFS> bfs = getDistanceBFS(i);
+        const AgentShape shape = P->getAgentShape(i);
+        const int limit = max_timestep;
+        DistanceTableCache* cache = distance_table_cache;
+        pending->done = distance_table_workers->submit(
+            [=] { lookupDistanceTable(cache, *bfs, grid, goal, shape, limit, *table); });
+    }
+
+    pending_tables[i] = std::move(pending);
+    ++async_distance_tables;
+}
+
+void LargeAgentsMAPFSolver::prefetchDistanceTables(const std::deque<Node*>& goals)
+{
+    if (!distance_table_workers || distance_oracle != DistanceOracle::EXACT) return;
+    const auto head = goals.begin() +
+        std::min<size_t>(goals.size(), PREFETCHED_GOALS_PER_WORKER * distance_table_workers->size());
+
+    // a goal that left the head is dropped, its worker holds the buffers
+    prefetched_tables.erase(
+        std::remove_if(prefetched_tables.begin(), prefetched_tables.end(),
+                       [&](auto& p) { return std::find(goals.begin(), head, p->goal) == head; }),
+        prefetched_tables.end());
+
+    // one agent of every shape class, for its BFS and shape
+    std::vector<int> agent_of_class(shape_classes.size(), NIL);
+    for (int i = P->getNum() - 1; i >= 0; --i) agent_of_class[shape_class_of[i]] = i;
+
+    for (auto itr = goals.begin(); itr != head; ++itr) {
+        Node* goal = *itr;
+        if (std::any_of(prefetched_tables.begin(), prefetched_tables.end(),
+                        [&](auto& p) { return p->goal == goal; }))
+            continue;
+        auto prefetched = std::make_unique<PrefetchedDistanceTables>();
+        prefetched->goal = goal;
+        std::vector<std::shared_ptr<const GridBFS>> bfs;
+        AgentShapes shapes;
+        for (auto i : agent_of_class) {
+            prefetched->tables.push_back(std::make_shared<std::vector<int>>());
+            bfs.push_back(getDistanceBFS(i));
+            shapes.push_back(P->getAgentShape(i));
+        }
+        auto tables = prefetched->tables;
+        Grid* grid = P->getGrid();
+        const int limit = max_timestep;
+        DistanceTableCache* cache = distance_table_cache;
+        prefetched->done = distance_table_workers->submit([=] {
+            for (size_t c = 0; c < tables.size(); ++c)
+                lookupDistanceTable(cache, *bfs[c], grid, goal, shapes[c], limit, *tables[c]);
+        });
+        prefetched_tables.push_back(std::move(prefetched));
+    }
+}
+
+void LargeAgentsMAPFSolver::syncDistanceTables()
+{
+    for (int i = 0; i < P->getNum(); ++i) {
+        auto& pending = pending_tables[i];
+        if (pending == nullptr ||
+            pending->done.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            continue;
+        distance_table[i].swap(*pending->table);
+        pending.reset();
+        createSuccessorOrder(i);
+    }
 }
 
 void LargeAgentsMAPFSolver::printResult()
@@ -166,11 +505,11 @@ void LargeAgentsMAPFSolver::computeLowerBounds()
     }
 }
 
-void LargeAgentsMAPFSolver::makeLogBasicInfo(std::ofstream& log)
+void LargeAgentsMAPFSolver::makeLogBasicInfo(std::ostream& log)
 {
 
     int size = int(P->getSizes().size());
-    Grid* grid = reinterpret_cast<Grid*>(P->getG());
+    Grid* grid = P->getGrid();
     log << "instance=" << P->getInstanceFileName() << "\n";
     log << "agents=" << P->getNum() << "\n";
     log << "sizes=";
@@ -178,6 +517,7 @@ void LargeAgentsMAPFSolver::makeLogBasicInfo(std::ofstream& log)
         log << P->getSize(i) << ", ";
     }
     log << P->getSize(size-1) << "\n";
+    log << "shape=" << getShapeName(P->getShape()) << "\n";
     log << "map_file=" << grid->getMapFileName() << "\n";
     log << "solver=" << solver_name << "\n";
     log << "solved=" << solved << "\n";
@@ -187,9 +527,26 @@ void LargeAgentsMAPFSolver::makeLogBasicInfo(std::ofstream& log)
     log << "lb_makespan=" << getLowerBoundMakespan() << "\n";
     log << "comp_time=" << getCompTime() << "\n";
     log << "preprocessing_comp_time=" << preprocessing_comp_time << "\n";
+    log << "distance_oracle=" << getDistanceOracleName(distance_oracle) << "\n";
+    log << "distance_memory_bytes=" << getDistanceMemory() << "\n";
+    if (distance_table_workers) {
+        log << "distance_table_workers=" << distance_table_workers->size() << "\n";
+        log << "async_distance_tables=" << async_distance_tables << "\n";
+        log << "prefetched_distance_tables=" << prefetched_distance_tables << "\n";
+    }
+    if (distance_table_cache) distance_table_cache->write(log);
+    if (lns_time_limit > 0) {
+        log << "lns_time_limit=" << lns_time_limit << "\n";
+        log << "lns_neighborhood_size=" << lns_neighborhood_size << "\n";
+        log << "lns_iterations=" << lns_iterations << "\n";
+        log << "lns_improvements=" << lns_improvements << "\n";
+        log << "lns_soc_over_time=";
+        for (auto& p : lns_soc_over_time) log << "(" << p.first << "," << p.second << "),";
+        log << "\n";
+    }
 }
 
-void LargeAgentsMAPFSolver::makeLogSolution(std::ofstream& log)
+void LargeAgentsMAPFSolver::makeLogSolution(std::ostream& log)
 {
     if (log_short) return;
     log << "starts=";
@@ -216,12 +573,33 @@ void LargeAgentsMAPFSolver::makeLogSolution(std::ofstream& log)
 
 int LargeAgentsMAPFSolver::pathDist(const int i, Node* const s) const
 {
+    if (pending_tables[i] != nullptr) {
+        // off the nodes the agent fits on, as a table would be
+        Node* g = P->getGoal(i);
+        if (s != g && !distance_bfs[shape_class_of[i]]->isOpen(s->pos.x, s->pos.y))
+            return max_timestep + 1;
+        return std::abs(s->pos.x - g->pos.x) + std::abs(s->pos.y - g->pos.y);
+    }
+    if (hierarchical_oracle_p != nullptr) {
+        return hierarchical_oracle_p->getDistance(i, s->id);
+    }
     if (distance_table_p != nullptr) {
         return distance_table_p->at(i)[s->id];
     }
     return distance_table[i][s->id];
 }
 
+size_t LargeAgentsMAPFSolver::getDistanceMemory() const
+{
+    if (hierarchical_oracle_p != nullptr) return hierarchical_oracle_p->getMemory();
+    const DistanceTable& tables = distance_table_p != nullptr ? *distance_table_p : distance_table;
+    const SuccessorOrder& orders = successor_order_p != nullptr ? *successor_order_p : successor_order;
+    size_t bytes = 0;
+    for (auto& table : tables) bytes += table.size() * sizeof(int);
+    for (auto& order : orders) bytes += order.size();
+    return bytes;
+}
+
 int LargeAgentsMAPFSolver::pathDist(const int i) const
 {
     return pathDist(i, P->getStart(i));
@@ -231,8 +609,27 @@ void LargeAgentsMAPFSolver::makeLog(const std::string& logfile)
 {
     std::ofstream log;
     log.open(logfile, std::ios::out);
+    makeLog(log);
+    log.close();
+}
+
+void LargeAgentsMAPFSolver::makeLog(std::ostream& log)
+{
     makeLogBasicInfo(log);
     makeLogSolution(log);
+}
+
+void LargeAgentsMAPFSolver::makeStats(const std::string& statsfile)
+{
+    std::ofstream log;
+    log.open(statsfile, std::ios::out);
+    log << "instance=" << P->getInstanceFileName() << "\n";
+    log << "solver=" << solver_name << "\n";
+    log << "solved=" << solved << "\n";
+    log << "comp_time=" << getCompTime() << "\n";
+    log << "preprocessing_comp_time=" << preprocessing_comp_time << "\n";
+    log << "timesteps=" << solution.getMakespan() << "\n";
+    makeLogStats(log);
     log.close();
 }
 
@@ -240,57 +637,94 @@ LargeAgentsMAPFSolver::~LargeAgentsMAPFSolver() = default;
 
 void LargeAgentsMAPFSolver::clearSizedPathTable(const PathsWithRadius& paths)
 {
-    const int makespan = paths.getMakespan();
     const int num_agents = paths.size();
     for (int i = 0; i < num_agents; ++i) {
         if (paths.empty(i)) continue;
-        auto p = paths.get(i);
-        for (int t = 0; t <= makespan; ++t) PATH_TABLE[t][p[t].node->id] = NIL;
+        reservations.release(i, paths.get(i));
     }
 }
 
 void LargeAgentsMAPFSolver::updateSizedPathTable(const PathsWithRadius& paths, const int id)
 {
-    const int makespan = paths.getMakespan();
     const int num_agents = paths.size();
-    const int nodes_size = G->getNodesSize();
-    // extend PATH_TABLE
-    while ((int)PATH_TABLE.size() < makespan + 1)
-        PATH_TABLE.push_back(std::vector<int>(nodes_size, NIL));
-    // update locations
     for (int i = 0; i < num_agents; ++i) {
         if (i == id || paths.empty(i)) continue;
-        auto p = paths.get(i);
-        for (int t = 0; t <= makespan; ++t) PATH_TABLE[t][p[t].node->id] = i;
+        reservations.reserve(i, paths.get(i));
     }
 }
 
 void LargeAgentsMAPFSolver::updateSizedPathTableWithoutClear(const int id, const PathWithRadius& path,
                                               const PathsWithRadius& paths)
 {
-    if (path.empty()) return;
+    // reservations do not depend on the other paths, the last node is kept forever
+    reservations.reserve(id, path);
+}
 
-    const int makespan = PATH_TABLE.size() - 1;
-    const int nodes_size = G->getNodesSize();
-    const int p_makespan = path.size() - 1;
+bool LargeAgentsMAPFSolver::sizedPathTableConflict(const int id, Node* const v, const int t) const
+{
+    return !reservations.isFree(v, id, t);
+}
+
+bool LargeAgentsMAPFSolver::sizedPathTableConflict(const int id, Node* const u, Node* const v,
+                                                   const int t) const
+{
+    if (sizedPathTableConflict(id, v, t)) return true;
+    if (u == v || t == 0) return false;
+    // swap
+    const int j = reservations.getOccupant(u, t);
+    return j != NIL && j != id && reservations.getOccupant(v, t - 1) == j;
+}
 
-    // extend PATH_TABLE
-    if (p_makespan > makespan) {
-        while ((int)PATH_TABLE.size() < p_makespan + 1)
-            PATH_TABLE.push_back(std::vector<int>(nodes_size, NIL));
-        for (int i = 0; i < P->getNum(); ++i) {
-            if (paths.empty(i)) continue;
-            auto v_id = paths.get(i, makespan).node->id;
-            for (int t = makespan + 1; t <= p_makespan; ++t) PATH_TABLE[t][v_id] = i;
+PathWithRadius LargeAgentsMAPFSolver::getSizedPathBySpaceTimeAstar(const int id,
+                                                                    const int max_cost,
+                                                                    const int time_limit)
+{
+    Node* const s = P->getStart(id);
+    Node* const g = P->getGoal(id);
+    const float size = P->getSize(id);
+
+    // the agent stays on its goal, which has to be free from the arrival on
+    const int horizon = reservations.getHorizon();
+    if (sizedPathTableConflict(id, g, horizon)) return {};
+    int goal_free_from = 0;
+    for (int t = horizon - 1; t >= 0; --t) {
+        if (sizedPathTableConflict(id, g, t)) {
+            goal_free_from = t + 1;
+            break;
         }
     }
 
-    // register new path
-    for (int t = 0; t <= p_makespan; ++t) PATH_TABLE[t][path[t].node->id] = id;
-    if (makespan > p_makespan) {
-        auto v_id = path[p_makespan].node->id;
-        for (int t = p_makespan + 1; t <= makespan; ++t) PATH_TABLE[t][v_id] = id;
+    AstarHeuristics fValue = [&](AstarNode* n) {
+        return std::max(n->g + pathDist(id, n->v), goal_free_from);
+    };
+    CheckAstarFin checkAstarFin = [&](AstarNode* n) {
+        return n->v == g && n->g >= goal_free_from;
+    };
+    CheckInvalidAstarNode checkInvalidAstarNode = [&](AstarNode* m) {
+        // also rejects nodes where the agent does not fit
+        const int f = m->g + pathDist(id, m->v);
+        if (f > max_timestep || f > max_cost) return true;
+        return sizedPathTableConflict(id, m->p->v, m->v, m->g);
+    };
+
+    Path path = getPathBySpaceTimeAstar(s, g, fValue, compareAstarNodeBasic, checkAstarFin,
+                                        checkInvalidAstarNode, time_limit, horizon + 1);
+    PathWithRadius sized_path;
+    for (auto v : path) sized_path.push_back({v, size});
+    return sized_path;
+}
+
+PathsWithRadius LargeAgentsMAPFSolver::planToSizedPaths(const Plan& plan) const
+{
+    const int num_agents = P->getNum();
+    PathsWithRadius paths(num_agents);
+    for (int i = 0; i < num_agents; ++i) {
+        PathWithRadius path;
+        for (int t = 0; t <= plan.getMakespan(); ++t)
+            path.push_back({plan.get(t, i), P->getSize(i)});
+        paths.insert(i, path);
     }
+    return paths;
 }
 
 Plan LargeAgentsMAPFSolver::sizedPathsToPlan(const PathsWithRadius& paths)
@@ -309,6 +743,127 @@ Plan LargeAgentsMAPFSolver::sizedPathsToPlan(const PathsWithRadius& paths)
     return plan;
 }
 
+// -------------------------------
+// large neighbourhood search
+// -------------------------------
+void LargeAgentsMAPFSolver::setLNS(int time_limit, int neighborhood_size)
+{
+    lns_time_limit = time_limit;
+    lns_neighborhood_size = neighborhood_size;
+}
+
+void LargeAgentsMAPFSolver::improveSolutionByLNS()
+{
+    TraceSpan span(trace, "lns", "lns");
+    const int deadline = std::min(max_comp_time, getSolverElapsedTime() + lns_time_limit);
+
+    PathsWithRadius paths = planToSizedPaths(solution);
+    updateSizedPathTable(paths, NIL);
+    int soc = solution.getSOC();
+    lns_soc_over_time.emplace_back(getSolverElapsedTime(), soc);
+    info("  LNS, initial soc:", soc);
+
+    while (getSolverElapsedTime() < deadline && !isCancelled()) {
+        std::vector<int> neighbors = selectNeighborhood(paths);
+        if (neighbors.empty()) break;  // every agent takes a shortest path
+        ++lns_iterations;
+
+        // the other agents keep their paths
+        PathsWithRadius candidate = paths;
+        int old_cost = 0;
+        int lower_bound = 0;
+        for (auto i : neighbors) {
+            old_cost += getSizedPathCost(paths.get(i));
+            lower_bound += pathDist(i);
+            reservations.release(i, paths.get(i));
+            candidate.clear(i);
+        }
+
+        // a neighbourhood without a cheaper plan makes the A* exhaust the space-time graph,
+        // so it gives up at its share of the budget instead of using the rest of it
+        const int iteration_deadline =
+            std::min(deadline, getSolverElapsedTime() +
+                                   std::max(1, lns_time_limit / LNS_ITERATION_SHARE));
+        bool replanned = true;
+        int new_cost = 0;
+        for (auto i : neighbors) {
+            // the remaining agents take at least their shortest paths
+            lower_bound -= pathDist(i);
+            const int max_cost = old_cost - 1 - new_cost - lower_bound;
+            const int time_limit = iteration_deadline - getSolverElapsedTime();
+            auto path = time_limit > 0 ? getSizedPathBySpaceTimeAstar(i, max_cost, time_limit)
+                                       : PathWithRadius();
+            if (path.empty()) {
+                replanned = false;
+                break;
+            }
+            updateSizedPathTableWithoutClear(i, path, candidate);
+            candidate.insert(i, path);
+            new_cost += getSizedPathCost(path);
+        }
+
+        if (!replanned || new_cost >= old_cost) {
+            for (auto i : neighbors) {
+                if (!candidate.empty(i)) reservations.release(i, candidate.get(i));
+                reservations.reserve(i, paths.get(i));
+            }
+            continue;
+        }
+        candidate.shrink();
+        paths = candidate;
+        soc -= old_cost - new_cost;
+        ++lns_improvements;
+        lns_soc_over_time.emplace_back(getSolverElapsedTime(), soc);
+        info("  LNS, iteration:", lns_iterations, ", soc:", soc);
+    }
+
+    info("  LNS, reservations:", reservations.size());
+    reservations.clear();
+    solution = sizedPathsToPlan(paths);
+}
+
+int LargeAgentsMAPFSolver::getSizedPathCost(const PathWithRadius& path)
+{
+    int c = 0;
+    while (path[c].node != path.back().node) ++c;
+    return c;
+}
+
+std::vector<int> LargeAgentsMAPFSolver::selectNeighborhood(const PathsWithRadius& paths)
+{
+    const int num_agents = P->getNum();
+    const int size = std::max(1, std::min(lns_neighborhood_size, num_agents));
+
+    // agents slower than their shortest path
+    std::vector<int> delayed;
+    for (int i = 0; i < num_agents; ++i)
+        if (getSizedPathCost(paths.get(i)) > pathDist(i)) delayed.push_back(i);
+    if (delayed.empty()) return {};
+    std::shuffle(delayed.begin(), delayed.end(), *MT);
+
+    std::vector<int> neighbors;
+    if (lns_iterations % 2 == 0) {
+        // the agents closest to a delayed agent at some timestep of its path
+        const int a = delayed[0];
+        const int t = getRandomInt(0, getSizedPathCost(paths.get(a)), MT);
+        Node* v = paths.get(a, t).node;
+        std::vector<std::pair<int, int>> by_distance;  // (distance, agent)
+        for (int i = 0; i < num_agents; ++i) {
+            Node* u = paths.get(i, t).node;
+            by_distance.emplace_back(
+                std::max(std::abs(u->pos.x - v->pos.x), std::abs(u->pos.y - v->pos.y)), i);
+        }
+        std::partial_sort(by_distance.begin(), by_distance.begin() + size, by_distance.end());
+        for (int k = 0; k < size; ++k) neighbors.push_back(by_distance[k].second);
+    } else {
+        // delayed agents anywhere
+        const int n = std::min(size, (int)delayed.size());
+        neighbors.assign(delayed.begin(), delayed.begin() + n);
+    }
+    std::shuffle(neighbors.begin(), neighbors.end(), *MT);  // replanning order
+    return neighbors;
+}
+
 std::unique_ptr<LargeAgentsMAPFSolver> getSolver(const std::string &solver_name,
                                                LargeAgentsMapfProblem *P,
                                                int inheritanceDepth, bool verbose,
@@ -318,7 +873,9 @@ std::unique_ptr<LargeAgentsMAPFSolver> getSolver(const std::string &solver_name,
     std::unique_ptr<LargeAgentsMAPFSolver> solver;
     if (solver_name == "LAPIBT")
     {
-        solver = std::make_unique<LAPIBT>(P, inheritanceDepth);
+        solver = withShape(P->getShape(), [&](auto S) -> std::unique_ptr<LargeAgentsMAPFSolver> {
+            return std::make_unique<LAPIBT<decltype(S)>>(P, inheritanceDepth);
+        });
     }
     else
     {
@@ -335,6 +892,6 @@ std::unique_ptr<LargeAgentsMAPFSolver> getSolver(const std::string &solver_name,
 }
 
 void LargeAgentsMAPFSolver::checkIfComputationTimeExceeded() {
-    if (getSolverElapsedTime() > max_comp_time)
+    if (getSolverElapsedTime() > max_comp_time || isCancelled())
         throw too_high_compute_time_exception();
 };
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <cmath>
+
+#include "../include/occupancy_raster.hpp"
+
+static const char *CONFLICT_BACKEND_NAMES[] = {"pairwise", "raster"};
+
+bool parseConflictBackend(const std::string &name, ConflictBackend &backend)
+{
+    for (auto b : {ConflictBackend::PAIRWISE, ConflictBackend::RASTER}) {
+        if (name != CONFLICT_BACKEND_NAMES[int(b)]) continue;
+        backend = b;
+        return true;
+    }
+    return false;
+}
+
+std::string getConflictBackendName(ConflictBackend backend)
+{
+    return CONFLICT_BACKEND_NAMES[int(backend)];
+}
+
+OccupancyRaster::OccupancyRaster(Grid *grid, const AgentShapes &shapes)
+    : width(grid->getWidth()), height(grid->getHeight()), words((width + 63) / 64),
+      paths(shapes.size())
+{
+    AgentShapes footprints;
+    for (auto &s : shapes) {
+        const AgentShape f = s.footprint();
+        auto itr = std::find(footprints.begin(), footprints.end(), f);
+        class_of.push_back(itr - footprints.begin());
+        if (itr != footprints.end()) continue;
+        footprints.push_back(f);
+
+        std::vector<Span> rows;
+        if (f.kind == ShapeKind::CIRCLE) {
+            // every cell a circle overlapping this one may also reach
+            const float r = f.w + 0.75f;
+            for (int dy = -int(std::ceil(r)); dy <= int(std::ceil(r)); ++dy) {
+                if (dy * dy >= r * r) continue;
+                const int dx = std::ceil(std::sqrt(r * r - dy * dy)) - 1;
+                rows.push_back({dy, -dx, dx});
+            }
+        } else {
+            const ShapeExtent e = getExtent(f);
+            for (int dy = e.y0; dy <= e.y1; ++dy) rows.push_back({dy, e.x0, e.x1});
+        }
+        spans.push_back(rows);
+    }
+}
+
+void OccupancyRaster::update(int id, int layer, Node *v, int d)
+{
+    if (layer >= (int)counts.size()) {
+        counts.resize(layer + 1, std::vector<uint16_t>(width * height, 0));
+        bits.resize(layer + 1, std::vector<uint64_t>(words * height, 0));
+        population.resize(layer + 1, 0);
+    }
+    population[layer] += d;
+
+    auto &count = counts[layer];
+    auto &bit = bits[layer];
+    for (auto &s : spans[class_of[id]]) {
+        const int y = v->pos.y + s.dy;
+        if (y < 0 || y >= height) continue;
+        const int x0 = std::max(0, v->pos.x + s.x0);
+        const int x1 = std::min(width - 1, v->pos.x + s.x1);
+        for (int x = x0; x <= x1; ++x) {
+            const uint16_t c = count[y * width + x] += d;
+            const uint64_t mask = uint64_t(1) << (x & 63);
+            if (d > 0 && c == 1) bit[y * words + (x >> 6)] |= mask;
+            if (d < 0 && c == 0) bit[y * words + (x >> 6)] &= ~mask;
+        }
+    }
+}
+
+void OccupancyRaster::setPath(int id, const std::deque<Node *> &path, size_t len)
+{
+    auto &nodes = paths[id];
+    size_t common = 0;
+    while (common < nodes.size() && common < len && nodes[common] == path[common]) ++common;
+    for (size_t k = nodes.size(); k > common; --k) update(id, k - 1, nodes[k - 1], -1);
+    nodes.resize(common);
+    for (size_t k = common; k < len; ++k) {
+        update(id, k, path[k], 1);
+        nodes.push_back(path[k]);
+    }
+}
+
+void OccupancyRaster::clear()
+{
+    static const std::deque<Node *> empty;
+    for (int id = 0; id < (int)paths.size(); ++id) setPath(id, empty, 0);
+}
+
+bool OccupancyRaster::intersects(int id, Node *v, int from) const
+{
+    const auto &rows = spans[class_of[id]];
+    for (int layer = from; layer < (int)counts.size(); ++layer) {
+        if (population[layer] == 0) continue;
+        const auto &bit = bits[layer];
+        for (auto &s : rows) {
+            const int y = v->pos.y + s.dy;
+            if (y < 0 || y >= height) continue;
+            const int x0 = std::max(0, v->pos.x + s.x0);
+            const int x1 = std::min(width - 1, v->pos.x + s.x1);
+            if (x0 > x1) continue;
+            const uint64_t *row = &bit[y * words];
+            for (int w = x0 >> 6; w <= x1 >> 6; ++w) {
+                uint64_t mask = ~uint64_t(0);
+                if (w == x0 >> 6) mask &= ~uint64_t(0) << (x0 & 63);
+                if (w == x1 >> 6) mask &= ~uint64_t(0) >> (63 - (x1 & 63));
+                if (row[w] & mask) return true;
+            }
+        }
+    }
+    return false;
+}
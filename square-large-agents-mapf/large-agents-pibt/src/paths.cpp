@@ -319,6 +319,7 @@ void PathsWithRadius::shrink() {
             paths[i].resize(paths[i].size() - 1);
         }
     }
+    makespan = getMaxLengthPaths();
 }
 
 
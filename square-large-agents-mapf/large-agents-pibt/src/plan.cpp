@@ -161,6 +161,17 @@ bool Plan::validate(const Config& starts) const
 }
 
 bool Plan::validate(LargeAgentsMapfProblem* P) const
+{
+    if (!validateWithoutGoals(P)) return false;
+
+    if (!sameConfig(last(), P->getConfigGoal())) {
+        warn("validation, invalid goals");
+        return false;
+    }
+    return true;
+}
+
+bool Plan::validateWithoutGoals(LargeAgentsMapfProblem* P) const
 {
     if (configs.empty()) return false;
 
@@ -169,12 +180,15 @@ bool Plan::validate(LargeAgentsMapfProblem* P) const
         return false;
     }
 
-    if (!sameConfig(last(), P->getConfigGoal())) {
-        warn("validation, invalid goals");
-        return false;
-    }
+    return withShape(P->getShape(), [&](auto S) { return validateMoves<decltype(S)>(P); });
+}
 
+template <class Shape>
+bool Plan::validateMoves(LargeAgentsMapfProblem* P) const
+{
     int num_agents = get(0).size();
+    const GridCSR& csr = P->getCSR();
+    Grid* grid = P->getGrid();
 
     for (int t = 1; t <= getMakespan(); ++t) {
         if ((int)configs[t].size() != num_agents) {
@@ -184,39 +198,31 @@ bool Plan::validate(LargeAgentsMapfProblem* P) const
         for (int i = 0; i < num_agents; ++i) {
             Node* v_i_t = get(t, i);
             Node* v_i_t_1 = get(t - 1, i);
-            int v_i_pos_x = v_i_t->pos.x;
-            int v_i_pos_y = v_i_t->pos.y;
-            float s_i = ceil(P->getSize(i));
+            const AgentShape& s_i = P->getAgentShape(i);
 
-            Nodes candidates = v_i_t_1->neighbor;
-            candidates.push_back(v_i_t_1);
-
-            if (!inArray(v_i_t, candidates)) {
+            if (v_i_t != v_i_t_1 && !csr.isNeighbor(v_i_t_1->id, v_i_t->id)) {
                 warn("validation, invalid move at t=" + std::to_string(t));
                 return false;
             }
+            if (v_i_t != v_i_t_1 && !Shape::fits(grid, v_i_t->pos.x, v_i_t->pos.y, s_i)) {
+                warn("validation, agent " + std::to_string(i) + " does not fit at ("
+                    + std::to_string(v_i_t->pos.x) + ", " + std::to_string(v_i_t->pos.y)
+                    + "), t=" + std::to_string(t));
+                return false;
+            }
 
             for (int j = i + 1; j < num_agents; ++j) {
                 Node* v_j_t = get(t, j);
                 Node* v_j_t_1 = get(t - 1, j);
-                int v_j_pos_x = v_j_t->pos.x;
-                int v_j_pos_y = v_j_t->pos.y;
-                float s_j = ceil(P->getSize(j));
-
-                if (
-                    (
-                      v_i_pos_x > v_j_pos_x - s_i &&
-                      v_i_pos_x < v_j_pos_x + s_j &&
-                      v_i_pos_y > v_j_pos_y - s_i &&
-                      v_i_pos_y < v_j_pos_y + s_j
-                    )
-                  ) {
+                const AgentShape& s_j = P->getAgentShape(j);
+
+                if (Shape::overlap(v_i_t->pos, s_i, v_j_t->pos, s_j)) {
                     warn("validation, vertex conflict at ("
                         + std::to_string(v_i_t->pos.x) + ", " + std::to_string(v_i_t->pos.y)
-                        + ", " + std::to_string(i) + ", " + std::to_string(s_i) + ")"
+                        + ", " + std::to_string(i) + ", " + getSizeName(s_i) + ")"
                         + " with agent ("
                         + std::to_string(v_j_t->pos.x) + ", " + std::to_string(v_j_t->pos.y)
-                        + ", " + std::to_string(j)  + ", " + std::to_string(s_j) +")"
+                        + ", " + std::to_string(j)  + ", " + getSizeName(s_j) +")"
                         + ", t=" + std::to_string(t));
                     return false;
                 }
@@ -0,0 +1,117 @@
+#include <fstream>
+#include <thread>
+
+#include "../include/portfolio.hpp"
+
+LargeAgentsMAPFPortfolio::LargeAgentsMAPFPortfolio(LargeAgentsMapfProblem *_P,
+                                                   const std::string &_solver_name,
+                                                   int num_members, int seed,
+                                                   int inheritanceDepth, bool _best_soc,
+                                                   std::function<void(LargeAgentsMAPFSolver *)> _configure)
+    : P(_P),
+      solver_name(_solver_name),
+      best_soc(_best_soc),
+      configure(std::move(_configure)),
+      cancelled(false),
+      winner(-1),
+      preprocessing_comp_time(0),
+      comp_time(0)
+{
+    const std::vector<int> depths = {inheritanceDepth, std::max(1, inheritanceDepth / 2),
+                                     2 * inheritanceDepth};
+    for (int k = 0; k < num_members; ++k)
+        members.push_back({seed + k, depths[k % depths.size()]});
+}
+
+void LargeAgentsMAPFPortfolio::solve()
+{
+    auto t_start = Time::now();
+
+    // distance tables once, shared read-only by all members
+    preprocessing_solver = getSolver(solver_name, P, members[0].inheritanceDepth, false, 0, nullptr);
+    configure(preprocessing_solver.get());
+    preprocessing_solver->initialize();
+    preprocessing_comp_time = preprocessing_solver->getPreprocessingCompTime();
+
+    // members get the time left, each with its own random generator
+    const int max_comp_time = std::max(0, P->getMaxCompTime() - preprocessing_comp_time);
+    for (size_t k = 0; k < members.size(); ++k) {
+        MTs.push_back(std::make_unique<std::mt19937>(members[k].seed));
+        problems.push_back(std::make_unique<LargeAgentsMapfProblem>(
+            P->getInstanceFileName(), P->getG(), MTs[k].get(), P->getConfigStart(),
+            P->getConfigGoal(), P->getAgentShapes(), P->getMaxTimestep(), max_comp_time));
+        solvers.push_back(getSolver(solver_name, problems[k].get(),
+                                    members[k].inheritanceDepth, false, 0, nullptr));
+        configure(solvers[k].get());
+        solvers[k]->shareDistanceTable(preprocessing_solver.get());
+        solvers[k]->setCancelFlag(&cancelled);
+    }
+
+    std::mutex mutex;
+    std::vector<std::thread> threads;
+    for (size_t k = 0; k < solvers.size(); ++k) {
+        threads.emplace_back([&, k] {
+            auto &solver = solvers[k];
+            solver->solve();
+
+            Member &member = members[k];
+            member.solved = solver->succeed();
+            member.valid = member.solved && solver->getSolution().validate(problems[k].get());
+            member.soc = solver->getSolution().getSOC();
+            member.comp_time = solver->getCompTime();
+            if (!member.valid) return;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (winner == -1 || (best_soc && member.soc < members[winner].soc)) winner = k;
+            if (!best_soc) cancelled = true;
+        });
+    }
+    for (auto &thread : threads) thread.join();
+
+    comp_time = int(getElapsedTime(t_start));
+}
+
+LargeAgentsMAPFSolver *LargeAgentsMAPFPortfolio::getWinner() const
+{
+    return winner == -1 ? nullptr : solvers[winner].get();
+}
+
+void LargeAgentsMAPFPortfolio::printResult() const
+{
+    std::cout << "portfolio of " << members.size() << ", winner=" << winner;
+    if (winner != -1) {
+        std::cout << " (seed=" << members[winner].seed
+                  << ", inheritanceDepth=" << members[winner].inheritanceDepth
+                  << "), soc=" << members[winner].soc;
+    }
+    std::cout << ", comp_time(ms)=" << comp_time << std::endl;
+}
+
+void LargeAgentsMAPFPortfolio::makeStats(const std::string &statsfile)
+{
+    if (solvers.empty()) return;
+    solvers[winner == -1 ? 0 : winner]->makeStats(statsfile);
+}
+
+void LargeAgentsMAPFPortfolio::makeLog(const std::string &logfile)
+{
+    // plan of the winner, otherwise of the first member
+    if (solvers.empty()) return;
+    solvers[winner == -1 ? 0 : winner]->makeLog(logfile);
+
+    std::ofstream log;
+    log.open(logfile, std::ios::app);
+    log << "portfolio_size=" << members.size() << "\n";
+    log << "portfolio_mode=" << (best_soc ? "best_soc" : "first") << "\n";
+    log << "portfolio_winner=" << winner << "\n";
+    log << "portfolio_comp_time=" << comp_time << "\n";
+    log << "portfolio_preprocessing_comp_time=" << preprocessing_comp_time << "\n";
+    log << "portfolio_members=";
+    for (size_t k = 0; k < members.size(); ++k) {
+        const Member &m = members[k];
+        log << "(" << m.seed << "," << m.inheritanceDepth << "," << m.solved << ","
+            << m.valid << "," << m.soc << "," << m.comp_time << "),";
+    }
+    log << "\n";
+    log.close();
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cmath>
+
+#include "../include/reservation_table.hpp"
+
+ReservationTable::ReservationTable(Grid* grid, const AgentShapes& _shapes, ShapeKind _shape)
+    : width(grid->getWidth()), height(grid->getHeight()), shape(_shape), shapes(_shapes)
+{
+    for (auto& s : shapes) {
+        const AgentShape f = s.footprint();
+        auto itr = std::find(footprints.begin(), footprints.end(), f);
+        class_of.push_back(itr - footprints.begin());
+        if (itr == footprints.end()) footprints.push_back(f);
+    }
+    blocked.resize(footprints.size());
+    parked.resize(footprints.size());
+}
+
+int ReservationTable::getArrival(const PathWithRadius& path)
+{
+    int arrival = path.size() - 1;
+    while (arrival > 0 && path[arrival - 1].node == path.back().node) --arrival;
+    return arrival;
+}
+
+void ReservationTable::reserve(int id, const PathWithRadius& path) { update(id, path, 1); }
+
+void ReservationTable::release(int id, const PathWithRadius& path) { update(id, path, -1); }
+
+void ReservationTable::update(int id, const PathWithRadius& path, int d)
+{
+    withShape(shape, [&](auto S) { update<decltype(S)>(id, path, d); });
+}
+
+template <class Shape>
+void ReservationTable::update(int id, const PathWithRadius& path, int d)
+{
+    if (path.empty()) return;
+    const int arrival = getArrival(path);
+
+    // calls f(k, anchor) for every anchor where footprint k collides with agent id at v
+    const AgentShape& s = shapes[id];
+    const ShapeExtent e = getExtent(s);
+    auto forEachBlockedAnchor = [&](Node* v, auto f) {
+        for (int k = 0; k < (int)footprints.size(); ++k) {
+            // anchors whose extent intersects the one of v
+            const ShapeExtent c = getExtent(footprints[k]);
+            const int y_min = std::max(0, v->pos.y + e.y0 - c.y1);
+            const int y_max = std::min(height - 1, v->pos.y + e.y1 - c.y0);
+            const int x_min = std::max(0, v->pos.x + e.x0 - c.x1);
+            const int x_max = std::min(width - 1, v->pos.x + e.x1 - c.x0);
+            for (int ay = y_min; ay <= y_max; ++ay)
+                for (int ax = x_min; ax <= x_max; ++ax) {
+                    if (!Shape::overlap(Pos(ax, ay), footprints[k], v->pos, s)) continue;
+                    f(k, ay * width + ax);
+                }
+        }
+    };
+
+    for (int t = 0; t < arrival; ++t) {
+        Node* v = path[t].node;
+        forEachBlockedAnchor(v, [&](int k, int anchor) {
+            const uint64_t key = getKey(t, anchor);
+            if ((blocked[k][key] += d) == 0) blocked[k].erase(key);
+        });
+        if (d > 0)
+            anchors[getKey(t, v->id)] = id;
+        else
+            anchors.erase(getKey(t, v->id));
+    }
+
+    Node* g = path[arrival].node;
+    forEachBlockedAnchor(g, [&](int k, int anchor) {
+        auto& arrivals = parked[k][anchor];
+        if (d > 0) {
+            arrivals.push_back(arrival);
+            return;
+        }
+        arrivals.erase(std::find(arrivals.begin(), arrivals.end(), arrival));
+        if (arrivals.empty()) parked[k].erase(anchor);
+    });
+    if (d > 0) {
+        parked_anchors[g->id] = {id, arrival};
+        horizon = std::max(horizon, arrival);
+    } else {
+        parked_anchors.erase(g->id);
+    }
+}
+
+void ReservationTable::clear()
+{
+    for (auto& b : blocked) b.clear();
+    for (auto& p : parked) p.clear();
+    anchors.clear();
+    parked_anchors.clear();
+    horizon = 0;
+}
+
+bool ReservationTable::isFree(Node* v, int id, int t) const
+{
+    const int k = class_of[id];
+    if (blocked[k].count(getKey(t, v->id)) != 0) return false;
+    auto itr = parked[k].find(v->id);
+    if (itr == parked[k].end()) return true;
+    for (auto arrival : itr->second)
+        if (arrival <= t) return false;
+    return true;
+}
+
+int ReservationTable::getOccupant(Node* v, int t) const
+{
+    auto itr = anchors.find(getKey(t, v->id));
+    if (itr != anchors.end()) return itr->second;
+    auto p = parked_anchors.find(v->id);
+    if (p != parked_anchors.end() && p->second.from <= t) return p->second.agent;
+    return -1;
+}
+
+size_t ReservationTable::size() const
+{
+    size_t n = anchors.size() + parked_anchors.size();
+    for (auto& b : blocked) n += b.size();
+    for (auto& p : parked) n += p.size();
+    return n;
+}
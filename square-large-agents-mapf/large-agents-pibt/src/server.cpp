@@ -0,0 +1,260 @@
+#include <array>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../include/server.hpp"
+
+LargeAgentsMAPFServer::LargeAgentsMAPFServer(const std::string &_socket_path,
+                                             size_t cache_bytes,
+                                             std::function<void(LargeAgentsMAPFSolver *)> _configure)
+    : socket_path(_socket_path),
+      cache(cache_bytes),
+      stopping(false),
+      listen_fd(-1),
+      configure(std::move(_configure)) {}
+
+LargeAgentsMAPFServer::~LargeAgentsMAPFServer()
+{
+    if (listen_fd != -1) close(listen_fd);
+}
+
+bool LargeAgentsMAPFServer::run()
+{
+    sockaddr_un addr{};
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cout << "error@Server: socket path " << socket_path << " is too long" << std::endl;
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    socket_path.copy(addr.sun_path, socket_path.size());
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path.c_str());
+    if (listen_fd == -1 || bind(listen_fd, (sockaddr *)&addr, sizeof(addr)) == -1 ||
+        listen(listen_fd, SOMAXCONN) == -1) {
+        std::cout << "error@Server: cannot listen on " << socket_path << std::endl;
+        return false;
+    }
+    std::cout << "listening on " << socket_path << std::endl;
+
+    while (!stopping) {
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd == -1) continue;
+        {
+            std::lock_guard<std::mutex> lock(clients_mutex);
+            clients.insert(fd);
+        }
+        // a thread per connection, an idle client must not hold back the others
+        try {
+            std::thread([this, fd] { serve(fd); }).detach();
+        } catch (const std::system_error &) {
+            std::cout << "warn@Server: cannot serve a connection" << std::endl;
+            closeClient(fd);
+        }
+    }
+
+    // wake up the connections waiting for a request and wait for their serve() to return
+    {
+        std::unique_lock<std::mutex> lock(clients_mutex);
+        for (auto fd : clients) ::shutdown(fd, SHUT_RDWR);
+        clients_closed.wait(lock, [this] { return clients.empty(); });
+    }
+
+    close(listen_fd);
+    listen_fd = -1;
+    unlink(socket_path.c_str());
+    return true;
+}
+
+void LargeAgentsMAPFServer::closeClient(int fd)
+{
+    // under the lock, accept() cannot reuse fd before it is erased
+    std::lock_guard<std::mutex> lock(clients_mutex);
+    clients.erase(fd);
+    close(fd);
+    clients_closed.notify_all();
+}
+
+void LargeAgentsMAPFServer::serve(int fd)
+{
+    std::string buffer;
+    std::vector<std::string> request;
+    char chunk[4096];
+
+    auto send = [fd](const std::string &msg) {
+        size_t sent = 0;
+        while (sent < msg.size()) {
+            // no SIGPIPE when the client is gone
+            ssize_t n = ::send(fd, msg.data() + sent, msg.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return;
+            sent += n;
+        }
+    };
+
+    ssize_t n;
+    while ((n = read(fd, chunk, sizeof(chunk))) > 0) {
+        buffer.append(chunk, n);
+        size_t pos;
+        while ((pos = buffer.find('\n')) != std::string::npos) {
+            std::string line = buffer.substr(0, pos);
+            buffer.erase(0, pos + 1);
+            if (!line.empty() && line.back() == 0x0d) line.pop_back();
+
+            if (line == "shutdown") {
+                stopping = true;
+                send("end\n");
+                // wake up accept()
+                ::shutdown(listen_fd, SHUT_RDWR);
+                closeClient(fd);
+                return;
+            }
+            if (line != "end") {
+                request.push_back(line);
+                continue;
+            }
+            send(solve(request) + "end\n");
+            request.clear();
+        }
+    }
+    closeClient(fd);
+}
+
+std::string LargeAgentsMAPFServer::solve(const std::vector<std::string> &request)
+{
+    std::string map_file;
+    std::vector<float> sizes;
+    std::vector<float> heights;  // of sizes given as wxh, -1 otherwise
+    std::vector<ShapeKind> kinds;
+    std::vector<std::array<int, 4>> scen;
+    int seed = DEFAULT_SEED;
+    int max_timestep = DEFAULT_MAX_TIMESTEP;
+    int max_comp_time = DEFAULT_MAX_COMP_TIME;
+    int inheritanceDepth = DEFAULT_INHERITANCE_DEPTH;
+    std::string solver_name = "LAPIBT";
+    ShapeKind shape = ShapeKind::SQUARE;
+    // solver options of the request, applied after configure
+    std::vector<std::function<void(LargeAgentsMAPFSolver *)>> options;
+
+    std::smatch results;
+    std::regex r_key_value = std::regex(R"((\w+)=(.*))");
+    std::regex r_sg = std::regex(R"((\d+),(\d+),(\d+),(\d+))");
+    try {
+        for (const auto &line : request) {
+            if (line.empty() || line[0] == '#') continue;
+            if (std::regex_match(line, results, r_sg)) {
+                scen.push_back({std::stoi(results[1].str()), std::stoi(results[2].str()),
+                                std::stoi(results[3].str()), std::stoi(results[4].str())});
+                continue;
+            }
+            if (!std::regex_match(line, results, r_key_value))
+                return "error=invalid line " + line + "\n";
+            const std::string key = results[1].str();
+            const std::string value = results[2].str();
+            if (key == "map_file") {
+                map_file = value;
+            } else if (key == "sizes") {
+                std::string size;
+                std::stringstream values(value);
+                while (std::getline(values, size, ',')) {
+                    float w, h;
+                    parseSize(std::regex_replace(size, std::regex(R"([()\s])"), ""), w, h);
+                    sizes.push_back(w);
+                    heights.push_back(h);
+                }
+            } else if (key == "seed") {
+                seed = std::stoi(value);
+            } else if (key == "max_timestep") {
+                max_timestep = std::stoi(value);
+            } else if (key == "max_comp_time") {
+                max_comp_time = std::stoi(value);
+            } else if (key == "inheritanceDepth") {
+                inheritanceDepth = std::stoi(value);
+            } else if (key == "solver") {
+                solver_name = value;
+            } else if (key == "shape") {
+                if (!parseShape(value, shape)) return "error=unknown shape " + value + "\n";
+            } else if (key == "shapes") {
+                std::string name;
+                std::stringstream names(value);
+                while (std::getline(names, name, ',')) {
+                    name = std::regex_replace(name, std::regex(R"(\s)"), "");
+                    kinds.emplace_back();
+                    if (!parseShape(name, kinds.back())) return "error=unknown shape " + name + "\n";
+                }
+            } else if (key == "log_short") {
+                const bool log_short = std::stoi(value);
+                options.push_back([=](LargeAgentsMAPFSolver *s) { s->setLogShort(log_short); });
+            } else if (key == "timestep_budget") {
+                const int budget = std::stoi(value);
+                options.push_back([=](LargeAgentsMAPFSolver *s) { s->setTimestepBudget(budget); });
+            } else if (key == "stall_window") {
+                const int window = std::stoi(value);
+                options.push_back([=](LargeAgentsMAPFSolver *s) { s->setStallWindow(window); });
+            } else if (key == "conflict_backend") {
+                ConflictBackend backend;
+                if (!parseConflictBackend(value, backend))
+                    return "error=unknown conflict backend " + value + "\n";
+                options.push_back([=](LargeAgentsMAPFSolver *s) { s->setConflictBackend(backend); });
+            } else if (key == "escape_search") {
+                EscapeSearch search;
+                if (!parseEscapeSearch(value, search)) return "error=unknown escape search " + value + "\n";
+                options.push_back([=](LargeAgentsMAPFSolver *s) { s->setEscapeSearch(search); });
+            } else if (key == "distance_oracle") {
+                DistanceOracle oracle;
+                if (!parseDistanceOracle(value, oracle))
+                    return "error=unknown distance oracle " + value + "\n";
+                options.push_back([=](LargeAgentsMAPFSolver *s) { s->setDistanceOracle(oracle); });
+            } else if (key == "lns_time_limit") {
+                const int time_limit = std::stoi(value);
+                options.push_back([=](LargeAgentsMAPFSolver *s) {
+                    s->setLNS(time_limit, DEFAULT_LNS_NEIGHBORHOOD_SIZE);
+                });
+            } else if (key == "distance_table_workers") {
+                const int workers = std::stoi(value);
+                options.push_back([=](LargeAgentsMAPFSolver *s) { s->setDistanceTableWorkers(workers); });
+            } else if (key != "agents") {
+                return "error=unknown key " + key + "\n";
+            }
+        }
+    } catch (std::logic_error &e) {
+        return "error=invalid number\n";
+    }
+
+    if (solver_name != "LAPIBT") return "error=unknown solver " + solver_name + "\n";
+    if (scen.empty()) return "error=no agents\n";
+    if (sizes.size() != scen.size()) return "error=number of sizes and agents differ\n";
+    Grid *G = maps.get(map_file);
+    if (G == nullptr) return "error=map " + map_file + " is not found or invalid\n";
+
+    AgentShapes shapes;
+    if (!makeAgentShapes(sizes, heights, shape, kinds, shapes))
+        return "error=sizes given as wxh have to be of rect agents\n";
+
+    Config starts, goals;
+    for (size_t i = 0; i < scen.size(); ++i) {
+        if (!fitsShape(G, scen[i][0], scen[i][1], shapes[i]) ||
+            !fitsShape(G, scen[i][2], scen[i][3], shapes[i]))
+            return "error=start or goal of agent " + std::to_string(i) + " does not fit\n";
+        starts.push_back(G->getNode(scen[i][0], scen[i][1]));
+        goals.push_back(G->getNode(scen[i][2], scen[i][3]));
+    }
+
+    std::mt19937 MT(seed);
+    LargeAgentsMapfProblem P(map_file, G, &MT, starts, goals, shapes, max_timestep,
+                             max_comp_time);
+    auto solver = getSolver(solver_name, &P, inheritanceDepth, false, 0, nullptr);
+    configure(solver.get());
+    for (auto &option : options) option(solver.get());
+    solver->setDistanceTableCache(&cache);
+    solver->setCancelFlag(&stopping);
+    solver->solve();
+
+    std::stringstream response;
+    solver->makeLog(response);
+    response << "valid=" << (solver->succeed() && solver->getSolution().validate(&P)) << "\n";
+    return response.str();
+}
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <numeric>
+
+#include "../include/solver_stats.hpp"
+
+void SolverStats::recordInheritanceDepth(int depth)
+{
+    if ((int)inheritance_depth_histogram.size() <= depth)
+        inheritance_depth_histogram.resize(depth + 1, 0);
+    inheritance_depth_histogram[depth]++;
+}
+
+void SolverStats::recordTimestepTime(const Time::time_point &t_start)
+{
+    timestep_times.push_back(
+        std::chrono::duration_cast<std::chrono::microseconds>(Time::now() - t_start).count());
+}
+
+long long SolverStats::getTotalTimestepTime() const
+{
+    return std::accumulate(timestep_times.begin(), timestep_times.end(), 0LL);
+}
+
+long long SolverStats::getTimestepTimePercentile(double percentile) const
+{
+    if (timestep_times.empty())
+        return 0;
+    std::vector<long long> sorted_times = timestep_times;
+    size_t k = std::min(sorted_times.size() - 1, size_t(percentile * sorted_times.size()));
+    std::nth_element(sorted_times.begin(), sorted_times.begin() + k, sorted_times.end());
+    return sorted_times[k];
+}
+
+void SolverStats::write(std::ostream &log) const
+{
+    log << "collision_conflict_calls=" << collision_conflict_calls << "\n";
+    log << "raster_confirmations=" << raster_confirmations << "\n";
+    log << "collision_conflict_in_inheritance_calls=" << collision_conflict_in_inheritance_calls << "\n";
+    log << "inheritance_conflict_calls=" << inheritance_conflict_calls << "\n";
+    log << "solve_inheritance_conflict_calls=" << solve_inheritance_conflict_calls << "\n";
+    log << "escape_attempts=" << escape_attempts << "\n";
+    log << "escape_depth_limit_hits=" << escape_depth_limit_hits << "\n";
+    log << "escape_targets_tried=" << escape_targets_tried << "\n";
+    log << "escape_random_skips=" << escape_random_skips << "\n";
+    log << "rollbacks=" << rollbacks << "\n";
+    log << "timestep_budget_fallbacks=" << timestep_budget_fallbacks << "\n";
+    log << "inheritance_depth_histogram=";
+    for (size_t depth = 0; depth < inheritance_depth_histogram.size(); ++depth)
+        log << (depth ? "," : "") << inheritance_depth_histogram[depth];
+    log << "\n";
+}
+
+void SolverStats::writeTimestepTimes(std::ostream &log, bool with_timesteps) const
+{
+    const int timesteps = timestep_times.size();
+    log << "timestep_time_total_us=" << getTotalTimestepTime() << "\n";
+    log << "timestep_time_mean_us=" << (timesteps ? getTotalTimestepTime() / timesteps : 0) << "\n";
+    log << "timestep_time_p50_us=" << getTimestepTimePercentile(0.5) << "\n";
+    log << "timestep_time_p99_us=" << getTimestepTimePercentile(0.99) << "\n";
+    log << "timestep_time_max_us="
+        << (timesteps ? *std::max_element(timestep_times.begin(), timestep_times.end()) : 0) << "\n";
+    if (!with_timesteps)
+        return;
+    log << "timestep_times_us=";
+    for (int t = 0; t < timesteps; ++t)
+        log << (t ? "," : "") << timestep_times[t];
+    log << "\n";
+}
@@ -0,0 +1,54 @@
+#include <algorithm>
+#include <fstream>
+
+#include "../include/trace.hpp"
+
+TraceWriter::TraceWriter(size_t _capacity)
+    : capacity(std::max(size_t(1), _capacity)), next(0), dropped(0), t_origin(Time::now())
+{
+}
+
+long long TraceWriter::now() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(Time::now() - t_origin).count();
+}
+
+void TraceWriter::add(const char *name, const char *category, long long ts,
+                      const char *arg_name, int arg)
+{
+    Event event = {name, category, arg_name, arg, ts, now() - ts};
+    if (ring.size() < capacity) {
+        // doubles as push_back() would, but never past capacity
+        if (ring.size() == ring.capacity())
+            ring.reserve(std::min(capacity, std::max(size_t(1024), 2 * ring.size())));
+        ring.push_back(event);
+    } else {
+        ring[next] = event;
+        ++dropped;
+    }
+    next = (next + 1) % capacity;
+}
+
+size_t TraceWriter::size() const { return ring.size(); }
+
+void TraceWriter::write(const std::string &tracefile) const
+{
+    std::ofstream trace;
+    trace.open(tracefile, std::ios::out);
+    trace << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" << dropped << "},\n";
+    trace << "\"traceEvents\":[\n";
+    // oldest event first, the ring starts at `next` once it has wrapped around
+    const size_t first = ring.size() < capacity ? 0 : next;
+    for (size_t k = 0; k < ring.size(); ++k) {
+        const Event &event = ring[(first + k) % ring.size()];
+        trace << (k ? ",\n" : "")
+              << "{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+              << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << event.ts
+              << ",\"dur\":" << event.dur;
+        if (event.arg_name != nullptr)
+            trace << ",\"args\":{\"" << event.arg_name << "\":" << event.arg << "}";
+        trace << "}";
+    }
+    trace << "\n]}\n";
+    trace.close();
+}